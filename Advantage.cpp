@@ -13,7 +13,7 @@ namespace Gaming {
     const double Advantage::ADVANTAGE_MULT_FACTOR = 2.0;
 
     Advantage::Advantage(const Game &g, const Position &p, double capacity)
-            : Resource (g, p, capacity) { __capacity = capacity * ADVANTAGE_MULT_FACTOR; }
+            : Resource (g, p, capacity * ADVANTAGE_MULT_FACTOR) { }
 
     Advantage::~Advantage() {
         // Not sure what to put here, again.
@@ -23,12 +23,9 @@ namespace Gaming {
         os << ADVANTAGE_ID << left << __id;
     }
 
-    double Advantage::getCapacity() const { return __capacity; }
-
     double Advantage::consume() {
-        __capacity = -1;
+        setCapacity(-1);
         finish();
-        return __capacity;
-
+        return getCapacity();
     }
 }
@@ -10,10 +10,8 @@
 
 namespace Gaming {
     class Advantage : public Resource {
-    private:
-        static const char ADVANTAGE_ID;
-
     public:
+        static const char ADVANTAGE_ID;
         static const double ADVANTAGE_MULT_FACTOR;
 
         Advantage(const Game &g, const Position &p, double capacity);
@@ -23,7 +21,6 @@ namespace Gaming {
 
         void print(std::ostream &os) const override;
 
-        double getCapacity() const override;
         double consume() override;
     };
 }
@@ -5,6 +5,24 @@ namespace Gaming {
 
     const double Agent::AGENT_FATIGUE_RATE = 0.3;
 
+    // rows: attacker type, columns: target type (SIMPLE, STRATEGIC, FOOD, ADVANTAGE)
+    const Agent::Interaction Agent::INTERACTIONS[ADVANTAGE + 1][ADVANTAGE + 1] = {
+            { interactAgent, interactAgent, interactResource, interactResource },   // SIMPLE
+            { interactAgent, interactAgent, interactResource, interactResource },   // STRATEGIC
+            { interactNone,  interactNone,  interactNone,     interactNone },       // FOOD
+            { interactNone,  interactNone,  interactNone,     interactNone }        // ADVANTAGE
+    };
+
+    void Agent::interactAgent(Agent &attacker, Piece &target) {
+        attacker.interact(static_cast<Agent *>(&target));
+    }
+
+    void Agent::interactResource(Agent &attacker, Piece &target) {
+        attacker.interact(static_cast<Resource *>(&target));
+    }
+
+    void Agent::interactNone(Agent &, Piece &) { }
+
     Agent::Agent(const Game &g, const Position &p, double energy) : Piece(g, p), __energy(energy) { }
 
     Agent::~Agent() {
@@ -19,15 +37,7 @@ namespace Gaming {
     }
 
     Piece &Agent::operator*(Piece &other) {
-        Piece *p = &other;
-        Resource *res = dynamic_cast<Resource*>(p);
-        if (res) {
-            interact(res);
-        }
-        Agent *agent = dynamic_cast<Agent*>(p);
-        if (agent) {
-            interact(agent);
-        }
+        INTERACTIONS[getType()][other.getType()](*this, other);
         if (!isFinished()) {
 
             Position posNew;
@@ -10,8 +10,19 @@
 
 namespace Gaming {
 
+    class Strategy;
+
     class Agent : public Piece {
 
+    private:
+        // interactions are dispatched on the (attacker, target) PieceType pair
+        typedef void (*Interaction)(Agent &attacker, Piece &target);
+        static const Interaction INTERACTIONS[ADVANTAGE + 1][ADVANTAGE + 1];
+
+        static void interactAgent(Agent &attacker, Piece &target);
+        static void interactResource(Agent &attacker, Piece &target);
+        static void interactNone(Agent &attacker, Piece &target);
+
     protected:
         double __energy;
 
@@ -22,6 +33,10 @@ namespace Gaming {
         ~Agent();
 
         double getEnergy() const { return __energy; }
+
+        // the strategy takeTurn() applies, if the agent decides through one;
+        // lets a round batch the decisions of agents sharing a strategy
+        virtual const Strategy *getStrategy() const { return nullptr; }
         void addEnergy(double e) { __energy += e; }
 
         void age() override final;
@@ -1,4 +1,3 @@
-#include <random>
 #include "Game.h"
 #include "AggressiveAgentStrategy.h"
 
@@ -8,86 +7,34 @@ namespace Gaming {
 
     const double AggressiveAgentStrategy::DEFAULT_AGGRESSION_THRESHOLD = Game::STARTING_AGENT_ENERGY * 0.75;
 
-    AggressiveAgentStrategy::AggressiveAgentStrategy(double agentEnergy) { __agentEnergy = agentEnergy; }
+    // agents first when energetic enough, then ADVANTAGE > EMPTY > FOOD
+    const DecisionTable AggressiveAgentStrategy::AGGRESSIVE_DECISIONS({ { SIMPLE, STRATEGIC }, { ADVANTAGE }, { EMPTY }, { FOOD } });
+    const DecisionTable AggressiveAgentStrategy::PASSIVE_DECISIONS({ { ADVANTAGE }, { EMPTY }, { FOOD } });
+
+    AggressiveAgentStrategy::AggressiveAgentStrategy(double agentEnergy) {
+        __agentEnergy = agentEnergy;
+        __decisions = (__agentEnergy > DEFAULT_AGGRESSION_THRESHOLD) ? &AGGRESSIVE_DECISIONS : &PASSIVE_DECISIONS;
+    }
 
     AggressiveAgentStrategy::~AggressiveAgentStrategy() { }
 
     ActionType AggressiveAgentStrategy::operator()(const Surroundings &s) const {
-        vector<int> positions;
-        default_random_engine gen;
-
-        if (__agentEnergy > DEFAULT_AGGRESSION_THRESHOLD) {
-            for (int i = 0; i < 9; ++i) {
-                if (s.array[i] == PieceType::SIMPLE || s.array[i] == PieceType::STRATEGIC) {
-                    positions.push_back(i);
-                }
-            }
-        }
-
-        if (positions.size() == 0) {
-            for (int i = 0; i < 9; ++i) {
-                if (s.array[i] == PieceType::ADVANTAGE) {
-                    positions.push_back(i);
-                }
-            }
-        }
-
-        if (positions.size() == 0) {
-            for (int i = 0; i < 9; ++i) {
-                if (s.array[i] == PieceType::EMPTY) {
-                    positions.push_back(i);
-                }
-            }
-        }
-
-        if (positions.size() == 0) {
-            for (int i = 0; i < 9; ++i) {
-                if (s.array[i] == PieceType::FOOD) {
-                    positions.push_back(i);
-                }
-            }
-        }
+        static thread_local CounterRng rng(0, CounterRng::TURN, 0, 0);
+        return (*this)(s, rng);
+    }
 
-        if (positions.size() > 0) {
+    ActionType AggressiveAgentStrategy::operator()(const Surroundings &s, CounterRng &rng) const {
+        return (*this)(packSurroundings(s), rng);
+    }
 
-            int index = positions[gen() % positions.size()];
-            if (positions.size() == 1) index = positions[0];
-            ActionType action;
-            switch (index) {
-                case 0: 
-                    action = NW; 
-                    break;
-                case 1: 
-                    action = N; 
-                    break;
-                case 2: 
-                    action = NE; 
-                    break;
-                case 3: 
-                    action = W; 
-                    break;
-                case 4: 
-                    action = STAY; 
-                    break;
-                case 5: 
-                    action = E; 
-                    break;
-                case 6: 
-                    action = SW; 
-                    break;
-                case 7: 
-                    action = S; 
-                    break;
-                case 8: 
-                    action = SE; 
-                    break;
-                default: 
-                    action = STAY;
-            }
-            return (action);
-        }
+    ActionType AggressiveAgentStrategy::operator()(SurroundingsKey key, CounterRng &rng) const {
+        return __decisions->pick(key, rng);
+    }
 
-        return ActionType::STAY;
+    void AggressiveAgentStrategy::decideBatch(const SurroundingsKey *keys, CounterRng *rngs,
+                         ActionType *actions, unsigned int n) const {
+        for (unsigned int k = 0; k < n; ++k)
+            actions[k] = __decisions->pick(keys[k], rngs[k]);
     }
 
 }
@@ -6,11 +6,15 @@
 #define PA5GAME_AGGRESSIVEAGENTSTRATEGY_H
 
 #include "Strategy.h"
+#include "DecisionTable.h"
 
 namespace Gaming {
 
     class AggressiveAgentStrategy : public Strategy {
+        static const DecisionTable AGGRESSIVE_DECISIONS, PASSIVE_DECISIONS;
+
         double __agentEnergy;
+        const DecisionTable *__decisions; // picked by __agentEnergy at construction
 
     public:
         static const double DEFAULT_AGGRESSION_THRESHOLD;
@@ -18,6 +22,10 @@ namespace Gaming {
         AggressiveAgentStrategy(double agentEnergy);
         ~AggressiveAgentStrategy();
         ActionType operator()(const Surroundings &s) const override;
+        ActionType operator()(const Surroundings &s, CounterRng &rng) const override;
+        ActionType operator()(SurroundingsKey key, CounterRng &rng) const override;
+        void decideBatch(const SurroundingsKey *keys, CounterRng *rngs,
+                         ActionType *actions, unsigned int n) const override;
 
     };
 
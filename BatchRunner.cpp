@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <cmath>
+#include "BatchRunner.h"
+#include "Agent.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+namespace Gaming {
+
+    BatchRunner::BatchRunner(unsigned int numThreads) : __threads(new ThreadPool(numThreads)) { }
+
+    BatchRunner::~BatchRunner() { }
+
+    unsigned int BatchRunner::getNumThreads() const { return __threads->getNumThreads(); }
+
+    // value at fraction q of a sorted, nonempty sample (nearest rank)
+    static double quantile(const vector<double> &sorted, double q) {
+        size_t rank = (size_t) (q * (sorted.size() - 1) + 0.5);
+        return sorted[rank];
+    }
+
+    BatchStats BatchRunner::run(const BatchConfig &config) {
+        BatchStats stats;
+        stats.games.resize(config.numGames);
+        vector<vector<double>> energies(config.numGames);
+
+        __threads->parallelFor(config.numGames, [&](unsigned int k) {
+            GameOutcome &outcome = stats.games[k];
+            outcome.seed = config.firstSeed + k;
+
+            Game g(config.width, config.height, false, outcome.seed);
+            g.setRoundMode(config.roundMode);
+            outcome.rounds = g.simulate(config.maxRounds);
+            outcome.over = (g.getStatus() == Game::OVER);
+            outcome.numSimple = g.getNumSimple();
+            outcome.numStrategic = g.getNumStrategic();
+            outcome.numResources = g.getNumResources();
+
+            g.forEachPiece([&](const Piece &piece) {
+                if (piece.getType() == SIMPLE || piece.getType() == STRATEGIC)
+                    energies[k].push_back(static_cast<const Agent &>(piece).getEnergy());
+            });
+        });
+
+        stats.numOver = 0;
+        stats.minRounds = stats.maxRounds = 0;
+        double rounds = 0, simple = 0, strategic = 0;
+        for (auto it = stats.games.begin(); it != stats.games.end(); ++it) {
+            if (it->over) ++stats.numOver;
+            if (it == stats.games.begin() || it->rounds < stats.minRounds) stats.minRounds = it->rounds;
+            if (it->rounds > stats.maxRounds) stats.maxRounds = it->rounds;
+            rounds += it->rounds;
+            simple += it->numSimple;
+            strategic += it->numStrategic;
+        }
+        unsigned int n = max(config.numGames, 1u);
+        stats.meanRounds = rounds / n;
+        stats.meanSimple = simple / n;
+        stats.meanStrategic = strategic / n;
+
+        vector<double> all;
+        for (auto it = energies.begin(); it != energies.end(); ++it)
+            all.insert(all.end(), it->begin(), it->end());
+        sort(all.begin(), all.end());
+
+        stats.numSurvivors = (unsigned int) all.size();
+        stats.minEnergy = stats.maxEnergy = stats.meanEnergy = stats.stddevEnergy = 0;
+        stats.medianEnergy = stats.p10Energy = stats.p90Energy = 0;
+        if (!all.empty()) {
+            double sum = 0, sumSq = 0;
+            for (auto it = all.begin(); it != all.end(); ++it) {
+                sum += *it;
+                sumSq += *it * *it;
+            }
+            stats.minEnergy = all.front();
+            stats.maxEnergy = all.back();
+            stats.meanEnergy = sum / all.size();
+            stats.stddevEnergy = sqrt(max(0.0, sumSq / all.size() - stats.meanEnergy * stats.meanEnergy));
+            stats.medianEnergy = quantile(all, 0.5);
+            stats.p10Energy = quantile(all, 0.1);
+            stats.p90Energy = quantile(all, 0.9);
+        }
+
+        return stats;
+    }
+
+}
@@ -0,0 +1,69 @@
+//
+// Runs many independent games in parallel and aggregates their outcomes.
+//
+
+#ifndef PA5GAME_BATCHRUNNER_H
+#define PA5GAME_BATCHRUNNER_H
+
+#include <memory>
+#include <vector>
+
+#include "Game.h"
+
+namespace Gaming {
+
+    class ThreadPool;
+
+    struct BatchConfig {
+        unsigned int width, height;
+        unsigned int numGames;
+        unsigned int firstSeed;     // game k is populated and played with seed firstSeed + k
+        unsigned int maxRounds;     // games still running after this many rounds are cut off (0: no cap)
+        Game::RoundMode roundMode;  // every mode replays identically for a seed
+
+        // games are spread over the threads and each runs on one, so TILED
+        // rounds would only walk tiles over a one-thread pool: SERIAL
+        BatchConfig(unsigned int width = 20, unsigned int height = 20, unsigned int numGames = 100) :
+                width(width), height(height), numGames(numGames),
+                firstSeed(0), maxRounds(1000), roundMode(Game::SERIAL) { }
+    };
+
+    struct GameOutcome {
+        unsigned int seed;
+        unsigned int rounds;
+        bool over;                  // false if cut off by maxRounds
+        unsigned int numSimple, numStrategic, numResources;
+    };
+
+    struct BatchStats {
+        std::vector<GameOutcome> games; // in seed order
+
+        unsigned int numOver;
+        unsigned int minRounds, maxRounds;
+        double meanRounds;
+        double meanSimple, meanStrategic; // survivors per game
+
+        // final energy of every surviving agent across the batch
+        unsigned int numSurvivors;
+        double minEnergy, maxEnergy, meanEnergy, stddevEnergy;
+        double medianEnergy, p10Energy, p90Energy;
+    };
+
+    class BatchRunner {
+        std::unique_ptr<ThreadPool> __threads;
+
+    public:
+        explicit BatchRunner(unsigned int numThreads = 1);
+        ~BatchRunner();
+
+        unsigned int getNumThreads() const;
+
+        // Every game owns its pieces, ids and random streams, so games share
+        // nothing and one thread plays each game start to finish. Results only
+        // depend on the config, not on the number of threads.
+        BatchStats run(const BatchConfig &config);
+    };
+
+}
+
+#endif //PA5GAME_BATCHRUNNER_H
@@ -0,0 +1,304 @@
+//
+// Microbenchmarks for the game engine.
+//
+// usage: ucd-csci2312-pa4-bench [--format json|csv] [--min-size N] [--max-size N]
+//                               [--min-time SECONDS] [--filter SUBSTRING]
+//
+// Grid sizes double from 4x4 (plus the minimal 3x3) up to --max-size, and each
+// size is run at several densities (fraction of cells holding a piece; a third
+// are agents, the rest resources, as in an automatically populated Game).
+// Results go to stdout, progress to stderr. Configure the build with
+// -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Game.h"
+#include "Simple.h"
+#include "DefaultAgentStrategy.h"
+#include "AggressiveAgentStrategy.h"
+#include "PriorityStrategy.h"
+#include "NeighborhoodKeys.h"
+
+using namespace std;
+using namespace Gaming;
+
+namespace {
+
+    typedef chrono::steady_clock Clock;
+
+    struct Result {
+        string name;
+        unsigned int size;
+        double density;
+        unsigned long long iterations; // operations timed
+        double itemsPerOp;             // e.g. cells per getSurroundings sweep
+        double nsPerOp;
+    };
+
+    struct Options {
+        string format = "json";
+        unsigned int minSize = 3;
+        unsigned int maxSize = 4096;
+        double minTime = 0.2;
+        string filter;
+    };
+
+    const double DENSITIES[] = { 0.25, 0.5, 0.75 };
+    const unsigned int MAX_SAMPLE = 4096; // neighborhoods fed to the strategy benchmarks
+
+    volatile unsigned long long sink; // keeps results observable to the optimizer
+
+    double seconds(Clock::duration d) { return chrono::duration<double>(d).count(); }
+
+    // Game with the given fraction of cells populated
+    Game *makeGame(unsigned int size, double density, unsigned int seed = Game::DEFAULT_SEED) {
+        Game *g = new Game(size, size, true, seed);
+        double pieces = (double) size * size * density;
+        g->populate((unsigned int) (pieces / 3), (unsigned int) (pieces * 2 / 3));
+        return g;
+    }
+
+    // Repeat op() (which returns the number of operations it did) until at least
+    // minTime has passed
+    template <class Op>
+    Result measure(const Options &opt, const string &name, unsigned int size, double density,
+                   double itemsPerOp, Op op) {
+        unsigned long long ops = 0;
+        Clock::duration elapsed(0);
+        while (seconds(elapsed) < opt.minTime) {
+            Clock::time_point start = Clock::now();
+            ops += op();
+            elapsed += Clock::now() - start;
+        }
+        Result r = { name, size, density, ops, itemsPerOp, seconds(elapsed) * 1e9 / ops };
+        return r;
+    }
+
+    // Like measure(), but setup() runs untimed before every operation
+    template <class Setup, class Op>
+    Result measureWithSetup(const Options &opt, const string &name, unsigned int size, double density,
+                            double itemsPerOp, Setup setup, Op op) {
+        unsigned long long ops = 0;
+        Clock::duration elapsed(0);
+        while (seconds(elapsed) < opt.minTime || ops == 0) {
+            setup();
+            Clock::time_point start = Clock::now();
+            op();
+            elapsed += Clock::now() - start;
+            ++ops;
+        }
+        Result r = { name, size, density, ops, itemsPerOp, seconds(elapsed) * 1e9 / ops };
+        return r;
+    }
+
+    void runSize(const Options &opt, unsigned int size, double density, vector<Result> &results) {
+        auto wanted = [&](const string &name) {
+            return opt.filter.empty() || name.find(opt.filter) != string::npos;
+        };
+        auto report = [&](const Result &r) {
+            cerr << r.name << " " << r.size << "x" << r.size << " @" << r.density
+                 << ": " << r.nsPerOp << " ns/op" << endl;
+            results.push_back(r);
+        };
+
+        Game *g = makeGame(size, density);
+        const double cells = (double) size * size;
+
+        if (wanted("getSurroundings"))
+            report(measure(opt, "getSurroundings", size, density, cells, [&]() {
+                unsigned long long sum = 0;
+                for (unsigned int x = 0; x < size; ++x)
+                    for (unsigned int y = 0; y < size; ++y)
+                        sum += g->getSurroundings(Position(x, y)).array[(x + y) % 9];
+                sink = sum;
+                return 1ull;
+            }));
+
+        if (wanted("neighborhoodKeys")) {
+            // the padded type plane of g, rebuilt from its pieces
+            vector<unsigned char> plane((size + 2) * (size + 2), INACCESSIBLE);
+            for (unsigned int x = 0; x < size; ++x)
+                for (unsigned int y = 0; y < size; ++y)
+                    plane[(x + 1) * (size + 2) + y + 1] = EMPTY;
+            g->forEachPiece([&](const Piece &piece) {
+                plane[(piece.getPosition().x + 1) * (size + 2) + piece.getPosition().y + 1] =
+                        (unsigned char) piece.getType();
+            });
+            vector<SurroundingsKey> keys(size);
+            report(measure(opt, string("neighborhoodKeys/") + neighborhoodKeysKernel(), size, density, cells, [&]() {
+                unsigned long long sum = 0;
+                for (unsigned int x = 0; x < size; ++x) {
+                    const unsigned char *row = &plane[(x + 1) * (size + 2) + 1];
+                    neighborhoodKeys(row - (size + 2), row, row + (size + 2), size, keys.data());
+                    sum += keys[x % size];
+                }
+                sink = sum;
+                return 1ull;
+            }));
+        }
+
+        if (wanted("isLegal"))
+            report(measure(opt, "isLegal", size, density, cells, [&]() {
+                unsigned long long sum = 0;
+                for (unsigned int x = 0; x < size; ++x)
+                    for (unsigned int y = 0; y < size; ++y)
+                        sum += g->isLegal((ActionType) ((x + y) % 9), Position(x, y));
+                sink = sum;
+                return 1ull;
+            }));
+
+        if (wanted("move"))
+            report(measure(opt, "move", size, density, cells, [&]() {
+                unsigned long long sum = 0;
+                for (unsigned int x = 0; x < size; ++x)
+                    for (unsigned int y = 0; y < size; ++y)
+                        sum += g->move(Position(x, y), (ActionType) ((x * 7 + y) % 9)).x;
+                sink = sum;
+                return 1ull;
+            }));
+
+        if (wanted("countNear"))
+            report(measure(opt, "countNear", size, density, cells, [&]() {
+                sink = g->countNear(typeSet(SIMPLE, STRATEGIC), typeSet(FOOD));
+                return 1ull;
+            }));
+
+        // neighborhoods of a sample of cells, for the decision benchmarks
+        vector<Surroundings> sample;
+        for (unsigned int i = 0; i < MAX_SAMPLE && i < size * size; ++i) {
+            unsigned int cell = (unsigned int) (((unsigned long long) i * 2654435761u) % (size * size));
+            sample.push_back(g->getSurroundings(Position(cell / size, cell % size)));
+        }
+        const double n = (double) sample.size();
+
+        DefaultAgentStrategy defaultStrategy;
+        AggressiveAgentStrategy aggressiveStrategy(Game::STARTING_AGENT_ENERGY);
+        const Strategy *strategies[] = { &defaultStrategy, &aggressiveStrategy };
+        const char *strategyNames[] = { "strategy/default", "strategy/aggressive" };
+        for (int k = 0; k < 2; ++k)
+            if (wanted(strategyNames[k]))
+                report(measure(opt, strategyNames[k], size, density, n, [&]() {
+                    unsigned long long sum = 0;
+                    for (unsigned int i = 0; i < sample.size(); ++i) {
+                        CounterRng rng(Game::DEFAULT_SEED, CounterRng::TURN, i, 0);
+                        sum += (*strategies[k])(sample[i], rng);
+                    }
+                    sink = sum;
+                    return 1ull;
+                }));
+
+        if (wanted("strategy/priority"))
+            report(measure(opt, "strategy/priority", size, density, n, [&]() {
+                Decision decide = &PriorityStrategy<ADVANTAGE, FOOD, EMPTY, SIMPLE>::decide;
+                unsigned long long sum = 0;
+                for (unsigned int i = 0; i < sample.size(); ++i) {
+                    CounterRng rng(Game::DEFAULT_SEED, CounterRng::TURN, i, 0);
+                    sum += decide(packSurroundings(sample[i]), rng);
+                }
+                sink = sum;
+                return 1ull;
+            }));
+
+        if (wanted("simple/takeTurn")) {
+            Simple simple(*g, Position(0, 0), Game::STARTING_AGENT_ENERGY);
+            report(measure(opt, "simple/takeTurn", size, density, n, [&]() {
+                unsigned long long sum = 0;
+                for (unsigned int i = 0; i < sample.size(); ++i)
+                    sum += simple.takeTurn(sample[i]);
+                sink = sum;
+                return 1ull;
+            }));
+        }
+
+        if (wanted("print"))
+            report(measure(opt, "print", size, density, cells, [&]() {
+                ostringstream os;
+                os << *g;
+                sink = os.str().size();
+                return 1ull;
+            }));
+
+        delete g;
+        g = nullptr;
+
+        if (wanted("populate"))
+            report(measureWithSetup(opt, "populate", size, density, cells * density,
+                                    [&]() { delete g; g = nullptr; },
+                                    [&]() { g = makeGame(size, density); }));
+        delete g;
+        g = nullptr;
+
+        if (wanted("round")) {
+            unsigned int seed = 0;
+            report(measureWithSetup(opt, "round", size, density, cells * density,
+                                    [&]() { delete g; g = makeGame(size, density, seed++); },
+                                    [&]() { g->round(); }));
+        }
+        delete g;
+    }
+
+    void printJson(ostream &os, const vector<Result> &results) {
+        os << "[" << endl;
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result &r = results[i];
+            os << "  {\"name\": \"" << r.name << "\", \"width\": " << r.size << ", \"height\": " << r.size
+               << ", \"density\": " << r.density << ", \"iterations\": " << r.iterations
+               << ", \"items_per_op\": " << r.itemsPerOp << ", \"ns_per_op\": " << r.nsPerOp
+               << ", \"ns_per_item\": " << r.nsPerOp / r.itemsPerOp << "}"
+               << (i + 1 < results.size() ? "," : "") << endl;
+        }
+        os << "]" << endl;
+    }
+
+    void printCsv(ostream &os, const vector<Result> &results) {
+        os << "name,width,height,density,iterations,items_per_op,ns_per_op,ns_per_item" << endl;
+        for (auto it = results.begin(); it != results.end(); ++it)
+            os << it->name << "," << it->size << "," << it->size << "," << it->density << ","
+               << it->iterations << "," << it->itemsPerOp << "," << it->nsPerOp << ","
+               << it->nsPerOp / it->itemsPerOp << endl;
+    }
+
+    void usage() {
+        cerr << "usage: ucd-csci2312-pa4-bench [--format json|csv] [--min-size N] [--max-size N]"
+             << " [--min-time SECONDS] [--filter SUBSTRING]" << endl;
+        exit(2);
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) usage();
+        const char *arg = argv[i], *val = argv[++i];
+        if (strcmp(arg, "--format") == 0) opt.format = val;
+        else if (strcmp(arg, "--min-size") == 0) opt.minSize = (unsigned int) atoi(val);
+        else if (strcmp(arg, "--max-size") == 0) opt.maxSize = (unsigned int) atoi(val);
+        else if (strcmp(arg, "--min-time") == 0) opt.minTime = atof(val);
+        else if (strcmp(arg, "--filter") == 0) opt.filter = val;
+        else usage();
+    }
+    if (opt.format != "json" && opt.format != "csv") usage();
+
+    vector<unsigned int> sizes;
+    if (opt.minSize <= Game::MIN_WIDTH) sizes.push_back(Game::MIN_WIDTH);
+    for (unsigned int size = 4; size <= opt.maxSize; size *= 2)
+        if (size >= opt.minSize) sizes.push_back(size);
+
+    vector<Result> results;
+    for (auto size = sizes.begin(); size != sizes.end(); ++size)
+        for (double density : DENSITIES)
+            runSize(opt, *size, density, results);
+
+    if (opt.format == "csv") printCsv(cout, results);
+    else printJson(cout, results);
+
+    return 0;
+}
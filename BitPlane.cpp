@@ -0,0 +1,74 @@
+#include "BitPlane.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Gaming {
+
+    const unsigned int BitPlane::WORD_BITS;
+
+    void BitPlane::resize(unsigned int rows, unsigned int stride) {
+        __rowWords = (stride + WORD_BITS - 1) / WORD_BITS;
+        __rows = rows;
+        __words.resize(rows * __rowWords);
+    }
+
+#if defined(__SSE2__)
+
+    static const unsigned int LANES = 16;
+    static const unsigned int MAX_TYPES = 8;
+
+    // the broadcast types of a typeSet, returns how many
+    static unsigned int broadcast(unsigned int types, __m128i *out) {
+        unsigned int n = 0;
+        for (unsigned int t = 0; t < MAX_TYPES; ++t)
+            if (types & (1u << t)) out[n++] = _mm_set1_epi8((char) t);
+        return n;
+    }
+
+    // bit i set if byte i of bytes equals one of the n types
+    static std::uint64_t matches(__m128i bytes, const __m128i *types, unsigned int n) {
+        __m128i hit = _mm_setzero_si128();
+        for (unsigned int i = 0; i < n; ++i)
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(bytes, types[i]));
+        return (std::uint64_t) (unsigned int) _mm_movemask_epi8(hit);
+    }
+
+#endif
+
+    // Full 16-cell runs of a word are compared against the type sets and
+    // their byte masks moved into bits; the tail of a row is packed a cell
+    // at a time. Bits past the end of a row are never set.
+    void BitPlane::pack(const unsigned char *typePlane, unsigned int rows, unsigned int stride,
+                        unsigned int whoTypes, BitPlane &who, unsigned int whatTypes, BitPlane &what) {
+        who.resize(rows, stride);
+        what.resize(rows, stride);
+#if defined(__SSE2__)
+        __m128i whoSet[MAX_TYPES], whatSet[MAX_TYPES];
+        const unsigned int whoCount = broadcast(whoTypes, whoSet), whatCount = broadcast(whatTypes, whatSet);
+#endif
+        for (unsigned int r = 0; r < rows; ++r) {
+            const unsigned char *row = typePlane + r * stride;
+            for (unsigned int w = 0; w < who.__rowWords; ++w) {
+                std::uint64_t whoBits = 0, whatBits = 0;
+                unsigned int c = w * WORD_BITS;
+                const unsigned int end = c + WORD_BITS < stride ? c + WORD_BITS : stride;
+#if defined(__SSE2__)
+                for (; c + LANES <= end; c += LANES) {
+                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + c));
+                    whoBits |= matches(bytes, whoSet, whoCount) << (c % WORD_BITS);
+                    whatBits |= matches(bytes, whatSet, whatCount) << (c % WORD_BITS);
+                }
+#endif
+                for (; c < end; ++c) {
+                    whoBits |= (std::uint64_t) ((whoTypes >> row[c]) & 1) << (c % WORD_BITS);
+                    whatBits |= (std::uint64_t) ((whatTypes >> row[c]) & 1) << (c % WORD_BITS);
+                }
+                who.word(r, w) = whoBits;
+                what.word(r, w) = whatBits;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,65 @@
+//
+// One bit per cell of a Game's padded grid.
+//
+
+#ifndef PA5GAME_BITPLANE_H
+#define PA5GAME_BITPLANE_H
+
+#include <cstdint>
+#include <vector>
+
+namespace Gaming {
+
+    inline unsigned int popCount(std::uint64_t word) {
+#if defined(__GNUC__)
+        return (unsigned int) __builtin_popcountll(word);
+#else
+        word -= (word >> 1) & 0x5555555555555555ull;
+        word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+        word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return (unsigned int) ((word * 0x0101010101010101ull) >> 56);
+#endif
+    }
+
+    // index of the lowest set bit of a nonzero word
+    inline unsigned int lowestBit(std::uint64_t word) {
+#if defined(__GNUC__)
+        return (unsigned int) __builtin_ctzll(word);
+#else
+        unsigned int i = 0;
+        while (!(word & 1)) { word >>= 1; ++i; }
+        return i;
+#endif
+    }
+
+    // One bit per cell of a padded plane: bit b of word w of row r is
+    // column 64 * w + b, every row starting on a fresh word. Bits past the
+    // end of a row are always clear.
+    class BitPlane {
+        unsigned int __rowWords; // words per row
+        unsigned int __rows;
+        std::vector<std::uint64_t> __words;
+
+        void resize(unsigned int rows, unsigned int stride); // contents left unspecified
+
+    public:
+        static const unsigned int WORD_BITS = 64;
+
+        BitPlane() : __rowWords(0), __rows(0) { }
+
+        // in one pass over a rows x stride type plane, the cells whose type
+        // is in whoTypes and those whose type is in whatTypes (typeSets of
+        // types below 8); the planes keep their storage across calls
+        static void pack(const unsigned char *typePlane, unsigned int rows, unsigned int stride,
+                         unsigned int whoTypes, BitPlane &who, unsigned int whatTypes, BitPlane &what);
+
+        unsigned int getRows() const { return __rows; }
+        unsigned int getRowWords() const { return __rowWords; }
+
+        std::uint64_t word(unsigned int row, unsigned int w) const { return __words[row * __rowWords + w]; }
+        std::uint64_t &word(unsigned int row, unsigned int w) { return __words[row * __rowWords + w]; }
+    };
+
+}
+
+#endif //PA5GAME_BITPLANE_H
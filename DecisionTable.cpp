@@ -0,0 +1,23 @@
+#include <algorithm>
+#include "DecisionTable.h"
+
+using namespace std;
+
+namespace Gaming {
+
+    const unsigned int DecisionTable::MAX_LEVELS;
+
+    DecisionTable::DecisionTable(const vector<vector<PieceType>> &levels) {
+        unsigned int numLevels = (unsigned int) min(levels.size(), (size_t) MAX_LEVELS);
+        for (unsigned int row = 0; row < ROW_KEYS; ++row) {
+            uint64_t word = 0;
+            for (unsigned int level = 0; level < numLevels; ++level)
+                for (auto type = levels[level].begin(); type != levels[level].end(); ++type)
+                    for (int c = 0; c < 3; ++c)
+                        if (keyCell(row, c) == *type)
+                            word |= (uint64_t) 1 << (9 * level + c);
+            __rows[row] = word;
+        }
+    }
+
+}
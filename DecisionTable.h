@@ -0,0 +1,58 @@
+//
+// Precompiled priority decisions over packed neighborhoods.
+//
+
+#ifndef PA5GAME_DECISIONTABLE_H
+#define PA5GAME_DECISIONTABLE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Gaming.h"
+
+namespace Gaming {
+
+    // A decision of the form "move to a random square holding a type of the
+    // first priority level that has any", compiled into a table.
+    //
+    // A full table over 27-bit keys would not fit any cache, so it is
+    // factored by row: each 9-bit row of a key indexes a word holding, for
+    // every level, the 3-bit mask of the row's squares on that level. The
+    // words of the three rows, shifted into place and or-ed, give the 9-bit
+    // candidate mask of every level side by side, and the first nonzero one
+    // is the decision. The table is 4 KB and built once, at startup.
+    class DecisionTable {
+    public:
+        static const unsigned int MAX_LEVELS = 7; // 9-bit masks in a 64-bit word
+
+    private:
+        static const unsigned int ROW_KEYS = 1 << (3 * KEY_CELL_BITS);
+
+        uint64_t __rows[ROW_KEYS];
+
+    public:
+        // levels in decreasing priority, each a set of piece types; levels
+        // past MAX_LEVELS are ignored
+        explicit DecisionTable(const std::vector<std::vector<PieceType>> &levels);
+
+        // 9-bit mask of the squares on the first level with any, 0 if none
+        unsigned int candidates(SurroundingsKey key) const {
+            uint64_t all = __rows[key & (ROW_KEYS - 1)]
+                           | __rows[(key >> (3 * KEY_CELL_BITS)) & (ROW_KEYS - 1)] << 3
+                           | __rows[(key >> (6 * KEY_CELL_BITS)) & (ROW_KEYS - 1)] << 6;
+            for (; all != 0; all >>= 9)
+                if (all & 0x1ff) return (unsigned int) (all & 0x1ff);
+            return 0;
+        }
+
+        // one uniform draw among the candidates, STAY (and no draw) if none
+        ActionType pick(SurroundingsKey key, CounterRng &rng) const {
+            unsigned int cells = candidates(key);
+            if (cells == 0) return STAY;
+            return CELL_ACTIONS[nthCell(cells, rng.below(cellCount(cells)))];
+        }
+    };
+
+}
+
+#endif //PA5GAME_DECISIONTABLE_H
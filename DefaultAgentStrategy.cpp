@@ -1,88 +1,38 @@
-#include <random>
 #include "DefaultAgentStrategy.h"
 
 using namespace std;
 
 namespace Gaming {
 
+    // ADVANTAGE > FOOD > EMPTY > SIMPLE
+    const DecisionTable DefaultAgentStrategy::DECISIONS({ { ADVANTAGE }, { FOOD }, { EMPTY }, { SIMPLE } });
+
     DefaultAgentStrategy::DefaultAgentStrategy() { }
 
     DefaultAgentStrategy::~DefaultAgentStrategy() { }
 
-    ActionType DefaultAgentStrategy::operator()(const Surroundings &s) const {
-        vector<int> positions;
-        default_random_engine gen;
+    const shared_ptr<const Strategy> &DefaultAgentStrategy::shared() {
+        static const shared_ptr<const Strategy> instance = make_shared<DefaultAgentStrategy>();
+        return instance;
+    }
 
-        
-        for (int i = 0; i < 9; ++i) {
-            if (s.array[i] == PieceType::ADVANTAGE) {
-                positions.push_back(i);
-            }
-        }
+    ActionType DefaultAgentStrategy::operator()(const Surroundings &s) const {
+        static thread_local CounterRng rng(0, CounterRng::TURN, 0, 0);
+        return (*this)(s, rng);
+    }
 
-        if (positions.size() == 0) {
-            for (int i = 0; i < 9; ++i) {
-                if (s.array[i] == PieceType::FOOD) {
-                    positions.push_back(i);
-                }
-            }
-        }
-        
-        if (positions.size() == 0) {
-            for (int i = 0; i < 9; ++i) {
-                if (s.array[i] == PieceType::EMPTY) {
-                    positions.push_back(i);
-                }
-            }
-        }
-        
-        if (positions.size() == 0) {
-            for (int i = 0; i < 9; ++i) {
-                if (s.array[i] == PieceType::SIMPLE) {
-                    positions.push_back(i);
-                }
-            }
-        }
+    ActionType DefaultAgentStrategy::operator()(const Surroundings &s, CounterRng &rng) const {
+        return (*this)(packSurroundings(s), rng);
+    }
 
-        if (positions.size() > 0) {
-            int index = positions[gen() % positions.size()];
-            if (positions.size() == 1) index = positions[0];
-            ActionType action;
-            switch (index) {
-                case 0:
-                    action = NW;
-                    break;
-                case 1:
-                    action = N;
-                    break;
-                case 2:
-                    action = NE;
-                    break;
-                case 3:
-                    action = W;
-                    break;
-                case 4:
-                    action = STAY;
-                    break;
-                case 5:
-                    action = E;
-                    break;
-                case 6:
-                    action = SW;
-                    break;
-                case 7:
-                    action = S;
-                    break;
-                case 8:
-                    action = SE;
-                    break;
-                default:
-                    action = STAY;
-            }
-            return (action);
-        }
+    ActionType DefaultAgentStrategy::operator()(SurroundingsKey key, CounterRng &rng) const {
+        return DECISIONS.pick(key, rng);
+    }
 
-        return ActionType::STAY;
+    void DefaultAgentStrategy::decideBatch(const SurroundingsKey *keys, CounterRng *rngs,
+                         ActionType *actions, unsigned int n) const {
+        for (unsigned int k = 0; k < n; ++k)
+            actions[k] = DECISIONS.pick(keys[k], rngs[k]);
     }
 
-}
\ No newline at end of file
+}
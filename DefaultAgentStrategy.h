@@ -5,16 +5,29 @@
 #ifndef PA5GAME_DEFAULTAGENTSTRATEGY_H
 #define PA5GAME_DEFAULTAGENTSTRATEGY_H
 
+#include <memory>
+
 #include "Strategy.h"
+#include "DecisionTable.h"
 
 namespace Gaming {
 
     class DefaultAgentStrategy : public Strategy {
+        static const DecisionTable DECISIONS;
+
     public:
 
         DefaultAgentStrategy();
         ~DefaultAgentStrategy();
+
+        // the strategy holds no state, so all agents can share one instance
+        static const std::shared_ptr<const Strategy> &shared();
+
         ActionType operator()(const Surroundings &s) const override;
+        ActionType operator()(const Surroundings &s, CounterRng &rng) const override;
+        ActionType operator()(SurroundingsKey key, CounterRng &rng) const override;
+        void decideBatch(const SurroundingsKey *keys, CounterRng *rngs,
+                         ActionType *actions, unsigned int n) const override;
     };
 
 }
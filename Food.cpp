@@ -14,21 +14,13 @@ namespace Gaming {
     const char Food::FOOD_ID = 'F';
 
     Food::Food(const Game &g, const Position &p, double capacity)
-    : Resource(g, p, capacity) { __capacity = capacity; }
+    : Resource(g, p, capacity) { }
 
     Food::~Food(){
         // Not sure what to put here. Who would want to delete food anyways.
     }
 
     void Food::print(ostream &os) const {
-        string s;
-        s = to_string(__id);
-        stringstream sstream;
-        sstream << Food::FOOD_ID;
-        sstream << s;
-        getline(sstream, s);
-        for (int i = 0; i < s.length(); ++i) {
-            os << s[i];
-        }
+        os << FOOD_ID << left << __id;
     }
 }
\ No newline at end of file
@@ -11,10 +11,9 @@
 namespace Gaming {
 
     class Food : public Resource {
-    private:
+    public:
         static const char FOOD_ID;
 
-    public:
         Food(const Game &g, const Position &p, double capacity);
         ~Food();
 
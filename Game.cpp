@@ -1,15 +1,21 @@
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 #include <fstream>
-#include <set>
+#include <functional>
+#include <random>
+#include <unordered_map>
 #include "Game.h"
+#include "NeighborhoodKeys.h"
 #include "Piece.h"
 #include "Resource.h"
 #include "Simple.h"
 #include "Strategic.h"
 #include "Food.h"
 #include "Advantage.h"
+#include "ThreadPool.h"
+#include "TerminalRenderer.h"
 
 using namespace std;
 
@@ -26,34 +32,47 @@ namespace Gaming {
     const unsigned Game::MIN_HEIGHT = 3;
     const double Game::STARTING_AGENT_ENERGY = 20;
     const double Game::STARTING_RESOURCE_CAPACITY = 10;
+    const unsigned int Game::TILE_SIZE = 32;
+    const unsigned int Game::DEFAULT_SEED = 0;
+    const unsigned int Game::FIRST_PIECE_ID = 1000;
+    const unsigned int Game::WHEEL_SIZE = 64; // longer than a resource of STARTING_RESOURCE_CAPACITY can last
     
-    PositionRandomizer Game::__posRandomizer = PositionRandomizer();
+
+    thread_local PositionRandomizer Game::__posRandomizer;
 
     // Default Constructor:
     Game::Game() {
         __numInitAgents = 0;
         __numInitResources = 0;
+        __seed = DEFAULT_SEED;
+        __idGen = FIRST_PIECE_ID;
         __width = MIN_WIDTH;
         __height = MIN_HEIGHT;
+        __spoilClock = 0;
+        __turnFlag = false;
 
-        for (int i=0; i < (__width*__height); i++)
-            __grid.push_back(nullptr);
+        initGrid();
 
         __round = 0;
         __status = NOT_STARTED;
         __verbose = false;
+        __roundMode = SERIAL;
+        __turnOrder = ID_ORDER;
     }
 
     // Constructor:
-    Game::Game(unsigned width, unsigned height, bool manual) : __width(width), __height(height) {
+    Game::Game(unsigned width, unsigned height, bool manual, unsigned int seed) :
+            __width(width), __height(height), __seed(seed) {
         if (width < MIN_HEIGHT || height < MIN_HEIGHT)
             throw InsufficientDimensionsEx(MIN_WIDTH, MIN_HEIGHT, width, height);
 
         __numInitAgents = 0;
         __numInitResources = 0;
+        __idGen = FIRST_PIECE_ID;
+        __spoilClock = 0;
+        __turnFlag = false;
 
-        for (int i=0; i < (__width * __height); i++)
-            __grid.push_back(nullptr);
+        initGrid();
 
         if (!manual)
             populate();
@@ -61,128 +80,242 @@ namespace Gaming {
         __round = 0;
         __status = NOT_STARTED;
         __verbose = false;
+        __roundMode = SERIAL;
+        __turnOrder = ID_ORDER;
 
     }
 
     // Destructor:
-    Game::~Game() { }
+    Game::~Game() {
+        for (auto it = __agents.begin(); it != __agents.end(); ++it)
+            destroyPiece(*it);
+        for (auto bucket = __wheel.begin(); bucket != __wheel.end(); ++bucket)
+            for (auto it = bucket->begin(); it != bucket->end(); ++it)
+                destroyPiece(*it);
+    }
+
+    // The planes carry a one-cell ring of INACCESSIBLE around the playing
+    // field, so that a neighborhood can be read without bounds checks.
+    void Game::initGrid() {
+        __stride = __width + 2;
+        __grid.assign(__stride * (__height + 2), nullptr);
+        __types.assign(__grid.size(), INACCESSIBLE);
+        for (unsigned int x = 0; x < __height; ++x)
+            for (unsigned int y = 0; y < __width; ++y)
+                __types[cellIndex(x, y)] = EMPTY;
+        __census.fill(0);
+        __wheel.assign(WHEEL_SIZE, vector<Piece *>());
+    }
 
     void Game::populate(){
         __numInitAgents = (__width * __height) / NUM_INIT_AGENT_FACTOR;
         __numInitResources = (__width * __height) / NUM_INIT_RESOURCE_FACTOR;
 
-        unsigned int numAdvantages = __numInitResources / 2;
-        unsigned int numStrategic = __numInitAgents / 2;
-        unsigned int numSimple = __numInitAgents / 2;
-        unsigned int numFoods = __numInitResources - numAdvantages;
-
-        // Taken from section 6.5 of the default README file:
-        default_random_engine gen;
-        uniform_int_distribution<int> d(0, __width * __height);
-
-        // populate Strategic agents:
-        while (numStrategic > 0) {
-            int i = d(gen);
-            if (i != (__width * __height) && __grid[i] == nullptr) {
-                Position pos(i / __width, i % __width);
-                __grid[i] = new Strategic(*this, pos, STARTING_AGENT_ENERGY);
-                numStrategic--;
+        populate(__numInitAgents, __numInitResources);
+    }
+
+    namespace {
+        // Distinct cell numbers from [0, n), uniformly, in O(1) each: a
+        // Fisher-Yates shuffle of 0..n-1 stopped after as many steps as there
+        // are draws. Only the entries moved so far are stored, in a hash map,
+        // unless a good share of the cells will be drawn and a plain array of
+        // all n is cheaper.
+        class CellSampler {
+            unsigned int __n, __drawn;
+            vector<unsigned int> __dense;
+            unordered_map<unsigned int, unsigned int> __moved;
+
+            unsigned int &at(unsigned int i) {
+                if (!__dense.empty()) return __dense[i];
+                return __moved.insert(make_pair(i, i)).first->second;
             }
-        }
 
-        // populate Simple agents:
-        while (numSimple > 0) {
-            int i = d(gen);
-            if (i != (__width * __height) && __grid[i] == nullptr) {
-                Position pos(i / __width, i % __width);
-                __grid[i] = new Simple(*this, pos, STARTING_AGENT_ENERGY);
-                numSimple--;
+        public:
+            CellSampler(unsigned int n, unsigned int draws) : __n(n), __drawn(0) {
+                if (draws >= n / 8) {
+                    __dense.resize(n);
+                    for (unsigned int i = 0; i < n; ++i) __dense[i] = i;
+                } else {
+                    __moved.reserve(2 * draws);
+                }
             }
-        }
 
+            bool isDense() const { return !__dense.empty(); }
 
-        // populate Advantage:
-        while (numAdvantages > 0) {
-            int i = d(gen);
-            if (i != (__width * __height) && __grid[i] == nullptr) {
-                Position pos(i / __width, i % __width);
-                __grid[i] = new Advantage(*this, pos, STARTING_RESOURCE_CAPACITY);
-                numAdvantages--;
+            unsigned int next(CounterRng &gen) { // at most n times
+                unsigned int i = __drawn++;
+                std::swap(at(i), at(i + gen.below(__n - i)));
+                return at(i);
             }
+        };
+    }
+
+    // Every piece lands on a fresh draw of the sampler, so there are no
+    // retries; only cells that were taken before populate() are skipped.
+    // The draws only mark their cells in __types, which takes one byte per
+    // piece, and the pieces are then made row-major, so that the grid is
+    // written in order and agents next to each other get neighbouring ids.
+    void Game::populate(unsigned int numAgents, unsigned int numResources) {
+        static const unsigned char DRAWN = 0x80; // marks a drawn cell, with the type of its piece
+
+        const unsigned int numCells = __width * __height;
+        unsigned int numTaken = getNumPieces();
+        unsigned int numFree = numCells - numTaken;
+        numAgents = min(numAgents, numFree);
+        numResources = min(numResources, numFree - numAgents);
+        const unsigned int numPieces = numAgents + numResources;
+        const unsigned int numStrategic = numAgents / 2, numAdvantages = numResources / 2;
+
+        CounterRng gen(__seed, CounterRng::POPULATE, 0, 0);
+        CellSampler cells(numCells, numPieces + numTaken);
+        vector<unsigned int> drawn;
+        const bool scan = cells.isDense(); // else sort the drawn cells
+        if (!scan) drawn.reserve(numPieces);
+
+        for (unsigned int placed = 0; placed < numPieces; ) {
+            unsigned int i = cells.next(gen);
+            unsigned int index = cellIndex(i / __width, i % __width);
+            if (__types[index] != EMPTY) continue;
+            PieceType type = placed < numStrategic ? STRATEGIC : placed < numAgents ? SIMPLE
+                           : placed < numAgents + numAdvantages ? ADVANTAGE : FOOD;
+            __types[index] = DRAWN | type;
+            if (!scan) drawn.push_back(i);
+            ++placed;
+        }
+
+        if (scan) {
+            drawn.clear();
+            for (unsigned int i = 0; i < numCells; ++i)
+                if (__types[cellIndex(i / __width, i % __width)] & DRAWN) drawn.push_back(i);
+        } else {
+            sort(drawn.begin(), drawn.end());
         }
 
-        // populate food:
-        while (numFoods > 0) {
-            int i = d(gen);
-            if (i != (__width * __height) && __grid[i] == nullptr) {
-                Position pos(i / __width, i % __width);
-                __grid[i] = new Food(*this, pos, STARTING_RESOURCE_CAPACITY);
-                numFoods--;
+        for (auto it = drawn.begin(); it != drawn.end(); ++it) {
+            Position pos(*it / __width, *it % __width);
+            unsigned int index = cellIndex(pos);
+            switch (__types[index] & ~DRAWN) {
+                case STRATEGIC:
+                    placePiece(index, __strategicPool.create(*this, pos, STARTING_AGENT_ENERGY)); break;
+                case SIMPLE:
+                    placePiece(index, __simplePool.create(*this, pos, STARTING_AGENT_ENERGY)); break;
+                case ADVANTAGE:
+                    placePiece(index, __advantagePool.create(*this, pos, STARTING_RESOURCE_CAPACITY)); break;
+                default:
+                    placePiece(index, __foodPool.create(*this, pos, STARTING_RESOURCE_CAPACITY)); break;
             }
         }
     }
 
-    unsigned int Game::getNumPieces() const { return getNumAgents() + getNumResources(); }
+    void Game::placePiece(unsigned int index, Piece *piece) {
+        piece->setTurned(__turnFlag); // plays next round
+        if (isAgent(piece->getType())) __agents.push_back(piece);
+        else schedule(piece);
+        __grid[index] = piece;
+        __types[index] = (unsigned char) piece->getType();
+        ++__census[__types[index]];
+    }
 
-    unsigned int Game::getNumAgents() const
-    { return getNumSimple() + getNumStrategic(); }
+    void Game::removePiece(unsigned int index) {
+        --__census[__types[index]];
+        __grid[index] = nullptr;
+        __types[index] = EMPTY;
+    }
 
-    unsigned int Game::getNumSimple() const {
-        unsigned int numAgents = 0;
+    void Game::swapCells(unsigned int a, unsigned int b) {
+        std::swap(__grid[a], __grid[b]);
+        std::swap(__types[a], __types[b]);
+    }
 
-        for (auto it = __grid.begin(); it != __grid.end(); ++it){
-            Simple *simple = dynamic_cast<Simple*>(*it);
-            if (simple) numAgents++;
+    void Game::destroyPiece(Piece *piece) {
+        switch (piece->getType()) {
+            case SIMPLE:
+                __simplePool.destroy(static_cast<Simple *>(piece)); break;
+            case STRATEGIC:
+                __strategicPool.destroy(static_cast<Strategic *>(piece)); break;
+            case FOOD:
+                __foodPool.destroy(static_cast<Food *>(piece)); break;
+            case ADVANTAGE:
+                __advantagePool.destroy(static_cast<Advantage *>(piece)); break;
+            default:
+                break;
         }
-        return numAgents;
     }
 
-    unsigned int Game::getNumStrategic() const {
-        unsigned int numStrat = 0;
-
-        for (auto it = __grid.begin(); it != __grid.end(); ++it)
-        {
-            Strategic *strategic = dynamic_cast<Strategic*>(*it);
-            if (strategic) numStrat++;
+    // The who and what cells are packed into bit planes first. Then, for each
+    // row, the what words of the rows above and below, shifted one column
+    // either way and unshifted, are ORed with those of the row itself shifted
+    // only: a word then holds every cell that has a what neighbour. The
+    // padding ring keeps the rows above and below in range and is never set.
+    // A row of the mask only needs the what rows around it, so it overwrites
+    // the who plane in place.
+    const BitPlane &Game::nearMask(unsigned int who, unsigned int what) const {
+        static const unsigned int PIECES = typeSet(SIMPLE, STRATEGIC, FOOD, ADVANTAGE);
+        const unsigned int rows = __height + 2;
+        BitPlane::pack(__types.data(), rows, __stride, who & PIECES, __nearWho, what & PIECES, __nearWhat);
+        const BitPlane &whatPlane = __nearWhat;
+        const unsigned int rowWords = __nearWho.getRowWords();
+
+        auto at = [&](unsigned int row, unsigned int w) { return w < rowWords ? whatPlane.word(row, w) : 0; };
+        auto shifted = [](uint64_t prev, uint64_t word, uint64_t next) {
+            return word << 1 | prev >> (BitPlane::WORD_BITS - 1) | word >> 1 | next << (BitPlane::WORD_BITS - 1);
+        };
+
+        for (unsigned int r = 1; r + 1 < rows; ++r) {
+            uint64_t prevAcross = 0, prevSide = 0;
+            uint64_t across = at(r - 1, 0) | at(r + 1, 0), side = at(r, 0);
+            for (unsigned int w = 0; w < rowWords; ++w) {
+                uint64_t nextAcross = at(r - 1, w + 1) | at(r + 1, w + 1);
+                uint64_t nextSide = at(r, w + 1);
+                uint64_t near = across | shifted(prevAcross, across, nextAcross) | shifted(prevSide, side, nextSide);
+                __nearWho.word(r, w) &= near;
+                prevAcross = across;
+                across = nextAcross;
+                prevSide = side;
+                side = nextSide;
+            }
         }
-        return numStrat;
-
+        return __nearWho;
     }
 
-    unsigned int Game::getNumResources() const {
-
-        unsigned int numResour = 0;
-
-        for (auto it = __grid.begin(); it != __grid.end(); ++it)
-        {
-            Resource *resource = dynamic_cast<Resource*>(*it);
-            if (resource) numResour++;
-        }
-        return numResour;
+    unsigned int Game::countNear(unsigned int who, unsigned int what) const {
+        const BitPlane &mask = nearMask(who, what);
+        unsigned int n = 0;
+        for (unsigned int r = 0; r < mask.getRows(); ++r)
+            for (unsigned int w = 0; w < mask.getRowWords(); ++w)
+                n += popCount(mask.word(r, w));
+        return n;
     }
 
     const Piece *  Game::getPiece(unsigned int x, unsigned int y) const {
-        unsigned int pos = (x *__width) + y;
+        if (x >= __height || y >= __width)
+            throw OutOfBoundsEx(__width, __height, x, y);
+        unsigned int pos = cellIndex(x, y);
         if (__grid[pos] == nullptr)
             throw PositionEmptyEx(x, y);
         return __grid[pos];
     }
 
+    const Piece *Game::pieceAt(unsigned int x, unsigned int y) const {
+        if (x >= __height || y >= __width)
+            throw OutOfBoundsEx(__width, __height, x, y);
+        unsigned int pos = cellIndex(x, y);
+        return isPiece(__types[pos]) ? __grid[pos] : nullptr;
+    }
+
     // grid population methods
     void Game::addSimple(const Position &position) {
         addSimple(position, STARTING_AGENT_ENERGY);
     }
 
     void Game::addSimple(const Position &position, double energy){
-        Simple *sim = new Simple(*this,position,energy);
-
-        if((position.x*__width + position.y)>__grid.size())
+        if(position.x >= __height || position.y >= __width)
             throw OutOfBoundsEx(__width,__height,position.x,position.y);
 
-        if((__grid[position.x*__width + position.y])!=nullptr)
+        if(__types[cellIndex(position)] != EMPTY)
             throw PositionNonemptyEx(position.x,position.y);
 
-        __grid[position.x*__width + position.y] = sim;
+        placePiece(cellIndex(position), __simplePool.create(*this, position, energy));
     }
 
     void Game::addSimple(unsigned x, unsigned y) {
@@ -196,33 +329,53 @@ namespace Gaming {
     }
 
     void Game::addStrategic(const Position &position, Strategy *s) {
-        Strategic *strat = new Strategic(*this,position,STARTING_RESOURCE_CAPACITY,s);
+        this->addStrategic(position, shared_ptr<const Strategy>(s));
+    }
+
+    void Game::addStrategic(unsigned x, unsigned y, Strategy *s) {
+        Position pos(x,y);
+        this->addStrategic(pos,s);
+    }
 
-        if((position.x*__width + position.y)>__grid.size())
+    void Game::addStrategic(const Position &position, shared_ptr<const Strategy> s) {
+        if(position.x >= __height || position.y >= __width)
             throw OutOfBoundsEx(__width,__height,position.x,position.y);
 
-        if((__grid[position.x*__width + position.y])!=nullptr)
+        if(__types[cellIndex(position)] != EMPTY)
             throw PositionNonemptyEx(position.x,position.y);
 
-        __grid[position.x*__width + position.y] = strat;
+        placePiece(cellIndex(position), __strategicPool.create(*this, position, STARTING_RESOURCE_CAPACITY, std::move(s)));
     }
 
-    void Game::addStrategic(unsigned x, unsigned y, Strategy *s) {
+    void Game::addStrategic(unsigned x, unsigned y, shared_ptr<const Strategy> s) {
         Position pos(x,y);
-        this->addStrategic(pos,s);
+        this->addStrategic(pos,std::move(s));
+    }
+
+    void Game::addStrategic(const Position &position, Decision d) {
+        if(position.x >= __height || position.y >= __width)
+            throw OutOfBoundsEx(__width,__height,position.x,position.y);
+
+        if(__types[cellIndex(position)] != EMPTY)
+            throw PositionNonemptyEx(position.x,position.y);
+
+        placePiece(cellIndex(position), __strategicPool.create(*this, position, STARTING_RESOURCE_CAPACITY, d));
+    }
+
+    void Game::addStrategic(unsigned x, unsigned y, Decision d) {
+        Position pos(x,y);
+        this->addStrategic(pos,d);
     }
 
     void Game::addFood(const Position &position)
     {
-        Food *foo = new Food(*this,position,STARTING_RESOURCE_CAPACITY);    // pun not intended
-
-        if((position.x*__width + position.y)>__grid.size())
+        if(position.x >= __height || position.y >= __width)
             throw OutOfBoundsEx(__width,__height,position.x,position.y);
 
-        if((__grid[position.x*__width + position.y])!=nullptr)
+        if(__types[cellIndex(position)] != EMPTY)
             throw PositionNonemptyEx(position.x,position.y);
 
-        __grid[position.x*__width + position.y] = foo;
+        placePiece(cellIndex(position), __foodPool.create(*this, position, STARTING_RESOURCE_CAPACITY));
     }
 
     void Game::addFood(unsigned x, unsigned y) {
@@ -231,15 +384,13 @@ namespace Gaming {
     }
 
     void Game::addAdvantage(const Position &position) {
-        Advantage *advan = new Advantage(*this,position,STARTING_RESOURCE_CAPACITY);
-
-        if((position.x*__width + position.y)>__grid.size())
+        if(position.x >= __height || position.y >= __width)
             throw OutOfBoundsEx(__width,__height,position.x,position.y);
 
-        if((__grid[position.x*__width + position.y])!=nullptr)
+        if(__types[cellIndex(position)] != EMPTY)
             throw PositionNonemptyEx(position.x,position.y);
 
-        __grid[position.x*__width + position.y] = advan;
+        placePiece(cellIndex(position), __advantagePool.create(*this, position, STARTING_RESOURCE_CAPACITY));
     }
 
     void Game::addAdvantage(unsigned x, unsigned y) {
@@ -250,19 +401,21 @@ namespace Gaming {
     const Surroundings Game::getSurroundings(const Position &pos) const {
 
         Surroundings surro;
-        for (int i = 0; i < 9; ++i) {
-            surro.array[i] = EMPTY;
-        }
-        for (int row = -1; row <= 1; ++row) {
-            for (int col = -1; col <= 1; ++col) {
-                if (pos.x + row >= 0 && pos.x + row < __height
-                    && pos.y + col >= 0 && pos.y + col < __width) {
-                    unsigned int index = pos.y + col + ((pos.x + row) * __width);
-                    if (__grid[index])
-                        surro.array[col + 1 + ((row + 1) * 3)] = __grid[index]->getType();
-                }
-                else {
-                    surro.array[col + 1 + ((row + 1) * 3)] = INACCESSIBLE;
+        if (pos.x < __height && pos.y < __width) {
+            // the INACCESSIBLE ring makes all nine reads valid
+            const unsigned char *row = &__types[cellIndex(pos) - __stride - 1];
+            for (int i = 0; i < 9; i += 3, row += __stride) {
+                surro.array[i] = (PieceType) row[0];
+                surro.array[i + 1] = (PieceType) row[1];
+                surro.array[i + 2] = (PieceType) row[2];
+            }
+        } else {
+            for (int row = -1; row <= 1; ++row) {
+                for (int col = -1; col <= 1; ++col) {
+                    if (pos.x + row < __height && pos.y + col < __width)
+                        surro.array[col + 1 + ((row + 1) * 3)] = (PieceType) __types[cellIndex(pos.x + row, pos.y + col)];
+                    else
+                        surro.array[col + 1 + ((row + 1) * 3)] = INACCESSIBLE;
                 }
             }
         }
@@ -301,6 +454,18 @@ namespace Gaming {
 
     }
 
+    SurroundingsKey Game::getSurroundingsKey(const Position &pos) const {
+        if (pos.x >= __height || pos.y >= __width)
+            return packSurroundings(getSurroundings(pos));
+
+        const unsigned char *row = &__types[cellIndex(pos) - __stride - 1];
+        SurroundingsKey key = 0;
+        for (int i = 0; i < 9; i += 3, row += __stride)
+            key |= ((SurroundingsKey) row[0] | (SurroundingsKey) row[1] << KEY_CELL_BITS
+                    | (SurroundingsKey) row[2] << (2 * KEY_CELL_BITS)) << (KEY_CELL_BITS * i);
+        return (key & ~(KEY_CELL_MASK << (4 * KEY_CELL_BITS))) | (SurroundingsKey) SELF << (4 * KEY_CELL_BITS);
+    }
+
     bool Game::isLegal(const ActionType &ac, const Position &pos) const {
         Surroundings ss = getSurroundings(pos);
         ActionType direction [9] =  {NW,N,NE,W,STAY,E,SW,S,SE};
@@ -362,52 +527,295 @@ namespace Gaming {
         return pos;
     }
 
-    void Game::round(){
-        set<Piece*> pieces;
-        for (auto it = __grid.begin(); it != __grid.end(); ++it) {
-            if (*it) {
-                pieces.insert(pieces.end(), *it);
-                (*it)->setTurned(false);
+    unsigned int Game::getNumThreads() const {
+        return __threads ? __threads->getNumThreads() : 1;
+    }
+
+    void Game::setRoundMode(RoundMode mode, unsigned int numThreads) {
+        __roundMode = mode;
+        if (numThreads == 0) numThreads = 1;
+        if (mode == SERIAL)
+            __threads.reset();
+        else if (!__threads || __threads->getNumThreads() != numThreads)
+            __threads.reset(new ThreadPool(numThreads));
+    }
+
+    void Game::playTurn(Piece *piece) {
+        if (piece->getTurned() == __turnFlag)
+            return;
+        piece->setTurned(__turnFlag);
+        piece->age();
+        ActionType ac = piece->takeTurn(getSurroundings(piece->getPosition()));
+        moveTo(piece, move(piece->getPosition(), ac));
+        if (!piece->isViable()) doom(piece);
+    }
+
+    void Game::moveTo(Piece *piece, const Position &pos1) {
+        Position pos0 = piece->getPosition();
+        if (pos0.x != pos1.x || pos0.y != pos1.y) {
+            unsigned int from = cellIndex(pos0);
+            unsigned int to = cellIndex(pos1);
+            if (isPiece(__types[to])) {
+                Piece *target = __grid[to];
+                bool viable = target->isViable();
+                (*piece) * (*target);
+                if (viable && !target->isViable()) doom(target);
+                if (piece->getPosition().x != pos0.x || piece->getPosition().y != pos0.y)
+                    swapCells(from, to);
+            } else {
+                piece->setPosition(pos1);
+                swapCells(from, to);
             }
         }
-        
-    for (auto it = pieces.begin(); it != pieces.end(); ++it) {
-            if (!(*it)->getTurned()) {
-                (*it)->setTurned(true);
-                (*it)->age();
-                ActionType ac = (*it)->takeTurn(getSurroundings((*it)->getPosition()));
-                Position pos0 = (*it)->getPosition();
-                Position pos1 = move(pos0, ac);
-                if (pos0.x != pos1.x || pos0.y != pos1.y) {
-                    Piece *p = __grid[pos1.y + (pos1.x * __width)];
-                    if (p) {
-                        (*(*it)) * (*p);
-                        if ((*it)->getPosition().x != pos0.x || (*it)->getPosition().y != pos0.y) {
-                            __grid[pos1.y + (pos1.x * __width)] = (*it);
-                            __grid[pos0.y + (pos0.x * __width)] = p;
-                        }
-                    } else {
-                        (*it)->setPosition(pos1);
-                        __grid[pos1.y + (pos1.x * __width)] = (*it);
-                        __grid[pos0.y + (pos0.x * __width)] = nullptr;
-                    }
-                }
+    }
+
+    // The grid is cut into TILE_SIZE x TILE_SIZE tiles colored like a 2x2
+    // checkerboard: color = 2 * (tile row % 2) + (tile column % 2). Colors are
+    // played in order 0..3, and within a tile pieces take turns row-major.
+    // A turn reads and writes only cells within one step of the piece, and two
+    // tiles of the same color are a whole tile apart, so all tiles of a color
+    // can run concurrently. The outcome is that of playing the tiles serially
+    // in this order, regardless of the number of threads.
+    void Game::tiledRound() {
+        const unsigned int tileRows = (__height + TILE_SIZE - 1) / TILE_SIZE;
+        const unsigned int tileCols = (__width + TILE_SIZE - 1) / TILE_SIZE;
+
+        for (unsigned int color = 0; color < 4; ++color) {
+            const unsigned int rowParity = color / 2, colParity = color % 2;
+            const unsigned int rows = (tileRows + 1 - rowParity) / 2;
+            const unsigned int cols = (tileCols + 1 - colParity) / 2;
+
+            __threads->parallelFor(rows * cols, [&](unsigned int t) {
+                unsigned int tr = (t / cols) * 2 + rowParity;
+                unsigned int tc = (t % cols) * 2 + colParity;
+                unsigned int xEnd = min((tr + 1) * TILE_SIZE, __height);
+                unsigned int yEnd = min((tc + 1) * TILE_SIZE, __width);
+                for (unsigned int x = tr * TILE_SIZE; x < xEnd; ++x)
+                    for (unsigned int y = tc * TILE_SIZE; y < yEnd; ++y)
+                        if (isAgent(__types[cellIndex(x, y)]))
+                            playTurn(__grid[cellIndex(x, y)]);
+            });
+        }
+    }
+
+    // INTENT rounds run in two phases:
+    // 1. Decide: every agent ages and picks its action against the grid as it
+    //    stood at the start of the round (resources spoil on their own, see
+    //    __spoilClock). Nothing moves on the grid, so the neighborhoods of all
+    //    cells are packed up front, a band of rows at a time, and the agents
+    //    are split across threads.
+    // 2. Resolve: when several agents target the same cell, the one with the
+    //    most energy keeps its move (on a tie, the one first in __agents, i.e.
+    //    the older one) and the others stay. Moves are then applied serially in
+    //    __agents (id) order, each meeting whatever occupies its target at that
+    //    point, as in a normal turn. Agents that stopped being viable earlier in
+    //    the phase don't move.
+    // The outcome doesn't depend on the number of threads.
+    void Game::intentRound() {
+        static const unsigned int CHUNK = 1024; // agents per parallel work item
+        static const unsigned int BAND = 16;    // rows of keys per parallel work item
+        const unsigned int NO_CLAIM = (unsigned int) __grid.size();
+
+        const unsigned int n = (unsigned int) __agents.size();
+        __targets.resize(n);
+        if (__claims.size() != __grid.size())
+            __claims.assign(__grid.size(), NO_CLAIM);
+        __keys.resize(__grid.size());
+
+        __threads->parallelFor((__height + BAND - 1) / BAND, [&](unsigned int b) {
+            for (unsigned int x = b * BAND; x < min(__height, (b + 1) * BAND); ++x) {
+                unsigned int i = cellIndex(x, 0);
+                neighborhoodKeys(&__types[i - __stride], &__types[i], &__types[i + __stride], __width, &__keys[i]);
             }
-        }        
-        
-    for (unsigned int i = 0; i < __grid.size(); ++i) {
-        if (__grid[i] && !(__grid[i]->isViable())) {
-            delete __grid[i];
-            __grid[i] = nullptr;
+        });
+
+        __threads->parallelFor((n + CHUNK - 1) / CHUNK, [&](unsigned int c) {
+            intentDecide(c * CHUNK, min(n, (c + 1) * CHUNK));
+        });
+
+        for (unsigned int k = 0; k < n; ++k) {
+            unsigned int to = __targets[k];
+            if (to == cellIndex(__agents[k]->getPosition())) continue;
+            unsigned int rival = __claims[to]; // ties go to the older agent
+            if (rival == NO_CLAIM ||
+                static_cast<Agent *>(__agents[k])->getEnergy() > static_cast<Agent *>(__agents[rival])->getEnergy())
+                __claims[to] = k;
+        }
+
+        for (unsigned int k = 0; k < n; ++k) {
+            unsigned int to = __targets[k];
+            if (__claims[to] != k) continue;
+            __claims[to] = NO_CLAIM;
+            if (__agents[k]->isViable())
+                moveTo(__agents[k], cellPosition(to));
         }
+
+        for (unsigned int k = 0; k < n; ++k)
+            if (!__agents[k]->isViable()) doom(__agents[k]);
     }
-    
-    if (getNumResources() <= 0) {
-        __status = Status::OVER;
+
+    namespace {
+        // an agent whose decision waits for the batch of its strategy
+        struct PendingDecision {
+            const Strategy *strategy;
+            unsigned int actor;
+            SurroundingsKey key;
+        };
+    }
+
+    // Agents that decide through a Strategy are grouped by it, and each
+    // group is decided by one decideBatch() call. Every agent still draws
+    // from its own (seed, id, round) generator, so the choices are the same
+    // as with one takeTurn() per agent.
+    void Game::intentDecide(unsigned int begin, unsigned int end) {
+        static thread_local vector<PendingDecision> pending;
+        static thread_local vector<SurroundingsKey> keys;
+        static thread_local vector<CounterRng> rngs;
+        static thread_local vector<ActionType> actions;
+
+        pending.clear();
+        for (unsigned int k = begin; k < end; ++k) {
+            Agent *agent = static_cast<Agent *>(__agents[k]);
+            agent->age();
+            Position pos = agent->getPosition();
+            const Strategy *strategy = agent->getStrategy();
+            SurroundingsKey key = __keys[cellIndex(pos)];
+            if (strategy == nullptr) {
+                __targets[k] = cellIndex(move(pos, agent->takeTurn(unpackSurroundings(key))));
+                continue;
+            }
+            PendingDecision d = { strategy, k, key };
+            pending.push_back(d);
         }
-        
-        __round++;
 
+        sort(pending.begin(), pending.end(), [](const PendingDecision &a, const PendingDecision &b) {
+            return less<const Strategy *>()(a.strategy, b.strategy);
+        });
+
+        for (size_t i = 0, j; i < pending.size(); i = j) {
+            keys.clear();
+            rngs.clear();
+            for (j = i; j < pending.size() && pending[j].strategy == pending[i].strategy; ++j) {
+                keys.push_back(pending[j].key);
+                rngs.push_back(CounterRng(__seed, CounterRng::TURN, __agents[pending[j].actor]->getId(), __round));
+            }
+            actions.resize(j - i);
+            pending[i].strategy->decideBatch(keys.data(), rngs.data(), actions.data(),
+                                             (unsigned int) (j - i));
+            for (size_t m = 0; m < j - i; ++m) {
+                unsigned int k = pending[i + m].actor;
+                __targets[k] = cellIndex(move(__agents[k]->getPosition(), actions[m]));
+            }
+        }
+    }
+
+    bool Game::onGrid(const Piece *piece) const {
+        return __grid[cellIndex(piece->getPosition())] == piece;
+    }
+
+    void Game::compactAgents() {
+        auto kept = __agents.begin();
+        for (auto it = __agents.begin(); it != __agents.end(); ++it) {
+            if (onGrid(*it)) *kept++ = *it;
+            else destroyPiece(*it);
+        }
+        __agents.erase(kept, __agents.end());
+    }
+
+    void Game::doom(Piece *piece) {
+        lock_guard<mutex> hold(__doomedLock);
+        __doomed.push_back(piece);
+    }
+
+    // A doomed agent may have eaten its way back to viability, and a piece
+    // may be doomed more than once; the checks here sort that out.
+    void Game::removeDoomed() {
+        for (auto it = __doomed.begin(); it != __doomed.end(); ++it)
+            if (onGrid(*it) && !(*it)->isViable())
+                removePiece(cellIndex((*it)->getPosition()));
+        __doomed.clear();
+    }
+
+    void Game::schedule(Piece *resource) {
+        unsigned int expiry = max(static_cast<Resource *>(resource)->getExpiry(), __spoilClock + 1);
+        __wheel[expiry % WHEEL_SIZE].push_back(resource);
+    }
+
+    void Game::expireResources() {
+        vector<Piece *> &bucket = __wheel[__spoilClock % WHEEL_SIZE];
+        auto kept = bucket.begin();
+        for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+            if (static_cast<Resource *>(*it)->getExpiry() > __spoilClock) {
+                *kept++ = *it; // a later lap of the wheel
+                continue;
+            }
+            unsigned int index = cellIndex((*it)->getPosition());
+            if (__grid[index] == *it) removePiece(index);
+            destroyPiece(*it);
+        }
+        bucket.erase(kept, bucket.end());
+    }
+
+    // The schedule is built in a buffer kept across rounds, so once it has
+    // grown to the number of agents a round allocates nothing.
+    const vector<Piece *> &Game::scheduleTurns() {
+        if (__turnOrder == ID_ORDER)
+            return __agents;
+
+        __schedule.clear();
+        if (__turnOrder == GRID_ORDER) {
+            for (unsigned int i = 0; i < __types.size(); ++i)
+                if (isAgent(__types[i])) __schedule.push_back(__grid[i]);
+        } else {
+            // Fisher-Yates over the id order
+            __schedule.assign(__agents.begin(), __agents.end());
+            CounterRng rng(__seed, CounterRng::SCHEDULE, 0, __round);
+            for (unsigned int i = (unsigned int) __schedule.size(); i > 1; --i)
+                std::swap(__schedule[i - 1], __schedule[rng.below(i)]);
+        }
+        return __schedule;
+    }
+
+    void Game::round(){
+        // a resource's turn is just spoiling, so the clock ticks for all of
+        // them at once and only agents take turns
+        ++__spoilClock;
+        __turnFlag = !__turnFlag;
+
+        if (__roundMode == SERIAL && __turnOrder == ID_ORDER) {
+            // one pass over the agents: drop those the last round removed
+            // and play the others
+            auto kept = __agents.begin();
+            for (auto it = __agents.begin(); it != __agents.end(); ++it) {
+                if (!onGrid(*it)) {
+                    destroyPiece(*it);
+                    continue;
+                }
+                *kept++ = *it;
+                playTurn(*it);
+            }
+            __agents.erase(kept, __agents.end());
+        } else {
+            compactAgents();
+            if (__roundMode == TILED) {
+                tiledRound();
+            } else if (__roundMode == INTENT) {
+                intentRound();
+            } else {
+                const vector<Piece *> &turns = scheduleTurns();
+                for (auto it = turns.begin(); it != turns.end(); ++it)
+                    playTurn(*it);
+            }
+        }
+
+        removeDoomed();
+        expireResources();
+
+        if (getNumResources() <= 0) {
+            __status = Status::OVER;
+        }
+
+        __round++;
     }
     
     void Game::play(bool verbose) {
@@ -421,35 +829,63 @@ namespace Gaming {
         if (!verbose) cout << *this;
     }
 
+    void Game::play(TerminalRenderer &view) {
+        __status = PLAYING;
+        view.draw(*this, true);
+        while (__status != OVER) {
+            round();
+            view.draw(*this);
+        }
+        view.finish(*this);
+    }
+
+    unsigned int Game::simulate(unsigned int maxRounds) {
+        unsigned int played = 0;
+        __status = PLAYING;
+        while (__status != OVER && (maxRounds == 0 || played < maxRounds)) {
+            round();
+            ++played;
+        }
+        return played;
+    }
+
+    // The board is formatted into one buffer, reused across calls, and
+    // written at once. Cells are laid out as the pieces print themselves:
+    // the letter of the type, then the id.
     ostream &operator<<(ostream &os, const Game &game) {
-      os << "Round " << game.__round << endl;
-        int column = 0;
-        for (auto it = game.__grid.begin(); it != game.__grid.end(); ++it) {
-            if (*it == nullptr) {
-                os << "[" << setw(6) << "]";
-            } else {
-                stringstream ss;
-                ss << "[" << **it;
-                string str;
-                getline(ss, str);
-                os << str << "]";
-            }
-            if (++column == game.__width) {
-                column = 0;
-                os << endl;
+        static const char EMPTY_CELL[] = "[     ]";
+        static thread_local string frame;
+
+        frame.clear();
+        frame.append("Round ");
+        appendNumber(frame, game.__round);
+        frame.push_back('\n');
+        for (unsigned int x = 0; x < game.__height; ++x) {
+            const unsigned int row = game.cellIndex(x, 0);
+            for (unsigned int y = 0; y < game.__width; ++y) {
+                const unsigned char type = game.__types[row + y];
+                if (!Game::isPiece(type)) {
+                    frame.append(EMPTY_CELL, sizeof EMPTY_CELL - 1);
+                } else {
+                    frame.push_back('[');
+                    appendLabel(frame, (PieceType) type, game.__grid[row + y]->getId());
+                    frame.push_back(']');
+                }
             }
+            frame.push_back('\n');
         }
-        os << "Status: ";
+        frame.append("Status: ");
         switch (game.getStatus()) {
             case Game::Status::NOT_STARTED:
-                cout << "Not Started..." << endl; break;
+                frame.append("Not Started...\n"); break;
             case Game::Status::PLAYING:
-                cout << "Playing..." << endl; break;
+                frame.append("Playing...\n"); break;
             default:
-                cout << "Over!" << endl; break;
+                frame.append("Over!\n"); break;
         }
-        return os;
-    }
 
+        os.write(frame.data(), frame.size());
+        return os << flush;
+    }
 }
 
@@ -5,50 +5,161 @@
 #ifndef PA5GAME_GAME_H
 #define PA5GAME_GAME_H
 
+#include <cstddef>
 #include <iostream>
 #include <vector>
 #include <array>
+#include <memory>
+#include <mutex>
 
 #include "Gaming.h"
 #include "DefaultAgentStrategy.h"
+#include "PiecePool.h"
+#include "BitPlane.h"
 
 namespace Gaming {
 
     class Piece;
     class Agent;
+    class Simple;
+    class Strategic;
+    class Food;
+    class Advantage;
+    class ThreadPool;
     class Strategy;
     class DefaultAgentStrategy;
+    class TerminalRenderer;
 
     class Game {
     public:
         enum Status { NOT_STARTED, PLAYING, OVER };
 
+        // SERIAL: agents take turns one by one, in the game's TurnOrder
+        // TILED: checkerboard tiles of the grid take turns in parallel (see tiledRound)
+        // INTENT: all agents decide in parallel, then moves are resolved (see intentRound)
+        enum RoundMode { SERIAL, TILED, INTENT };
+
+        // order of turns in SERIAL rounds
+        // ID_ORDER: oldest agent first
+        // GRID_ORDER: row-major by position at the start of the round
+        // SHUFFLED: a fresh permutation every round, drawn from the game's seed
+        enum TurnOrder { ID_ORDER, GRID_ORDER, SHUFFLED };
+
     private:
         static const unsigned int NUM_INIT_AGENT_FACTOR;
         static const unsigned int NUM_INIT_RESOURCE_FACTOR;
 
-        static PositionRandomizer __posRandomizer;
+        static thread_local PositionRandomizer __posRandomizer;
 
         void populate(); // populate the grid (used in automatic random initialization of a Game)
 
         unsigned __numInitAgents, __numInitResources;
 
         unsigned __width, __height;
+        // Both planes are padded with a one-cell ring around the board, so a
+        // cell's eight neighbours are always in range: the ring reads as
+        // INACCESSIBLE in __types and nullptr in __grid.
+        unsigned int __stride; // __width + 2
         std::vector<Piece *> __grid; // if a position is empty, nullptr
+        std::vector<unsigned char> __types; // dense PieceType plane parallel to __grid, EMPTY if vacant
+        std::array<unsigned int, ADVANTAGE + 1> __census; // number of pieces of each type on the grid
+        // bits of the pieces of a type in who with a piece of a type in what
+        // among their eight neighbours, laid over the padded grid; built from
+        // __types on demand, so rounds never pay for it, in planes kept
+        // across calls and valid until the next one
+        mutable BitPlane __nearWho, __nearWhat;
+        const BitPlane &nearMask(unsigned int who, unsigned int what) const;
+
+        void initGrid(); // size the padded planes for __width x __height
+
+        unsigned int cellIndex(unsigned int x, unsigned int y) const { return (x + 1) * __stride + y + 1; }
+        unsigned int cellIndex(const Position &pos) const { return cellIndex(pos.x, pos.y); }
+        Position cellPosition(unsigned int index) const {
+            return Position(index / __stride - 1, index % __stride - 1);
+        }
+        static bool isPiece(unsigned char type) { return type <= ADVANTAGE; }
+        static bool isAgent(unsigned char type) { return type <= STRATEGIC; }
+
+        // agents in creation (id) order; rounds play these only. Agents taken
+        // off the grid stay listed until the next round drops and destroys them.
+        std::vector<Piece *> __agents;
+        bool onGrid(const Piece *piece) const;
+        void compactAgents();
+
+        // Resources spoil lazily against __spoilClock, which ticks once at the
+        // start of every round. From placement until it is destroyed, every
+        // resource sits in the __wheel bucket of its expiry (mod WHEEL_SIZE).
+        // Eaten resources leave the grid at the end of the round they are
+        // eaten in and wait there.
+        static const unsigned int WHEEL_SIZE;
+        unsigned int __spoilClock;
+        std::vector<std::vector<Piece *>> __wheel;
+
+        void schedule(Piece *resource);
+        void expireResources(); // at the end of every round
+
+        // Pieces that stopped being viable during the round; only these are
+        // checked (and taken off the grid) at its end.
+        std::vector<Piece *> __doomed;
+        std::mutex __doomedLock; // TILED rounds play in parallel
+        void doom(Piece *piece);
+        void removeDoomed();
+
+        // all grid mutation goes through these so that __grid and __types never disagree
+        void placePiece(unsigned int index, Piece *piece);
+        void removePiece(unsigned int index);
+        void swapCells(unsigned int a, unsigned int b);
+
+        // the Game owns its pieces: they live in per-type slab pools and are
+        // handed back to them when they leave the grid or the Game dies
+        PiecePool<Simple> __simplePool;
+        PiecePool<Strategic> __strategicPool;
+        PiecePool<Food> __foodPool;
+        PiecePool<Advantage> __advantagePool;
+
+        void destroyPiece(Piece *piece);
 
         unsigned int __round;
+        unsigned int __seed; // keys every random draw made by the pieces of this game
+        mutable unsigned int __idGen; // ids of pieces created for this game, see Piece::Piece
+
+        friend class Piece;
 
         Status __status;
 
         bool __verbose;
 
+        RoundMode __roundMode;
+        std::unique_ptr<ThreadPool> __threads;
+
+        bool __turnFlag; // flips every round; a piece has played once its turned flag matches
+
+        TurnOrder __turnOrder;
+        std::vector<Piece *> __schedule; // reused by SERIAL rounds, see scheduleTurns()
+        const std::vector<Piece *> &scheduleTurns(); // agents of a SERIAL round in __turnOrder
+
+        // buffers reused by INTENT rounds
+        std::vector<unsigned int> __targets; // cell each of __agents wants to move to
+        std::vector<unsigned int> __claims;  // per cell, the agent allowed to move there
+        std::vector<SurroundingsKey> __keys; // per cell, its neighborhood at the start of the round
+
+        void playTurn(Piece *piece); // age, decide, and move/interact a single piece
+        void moveTo(Piece *piece, const Position &pos1); // move, or interact with the occupant
+        void tiledRound();
+        void intentRound();
+        void intentDecide(unsigned int begin, unsigned int end); // __targets of __agents[begin, end)
+
     public:
         static const unsigned MIN_WIDTH, MIN_HEIGHT;
         static const double STARTING_AGENT_ENERGY;
         static const double STARTING_RESOURCE_CAPACITY;
+        static const unsigned int TILE_SIZE; // side of a tile in TILED rounds, at least 2
+        static const unsigned int DEFAULT_SEED;
+        static const unsigned int FIRST_PIECE_ID;
 
         Game();
-        Game(unsigned width, unsigned height, bool manual = true); // note: manual population by default
+        Game(unsigned width, unsigned height, bool manual = true, // note: manual population by default
+             unsigned int seed = DEFAULT_SEED);
         Game(const Game &another);
         Game &operator=(const Game &other) = delete;
         ~Game();
@@ -56,27 +167,48 @@ namespace Gaming {
         // getters
         unsigned int getWidth() const { return __width; }
         unsigned int getHeight() const { return __height; }
-        unsigned int getNumPieces() const;
-        unsigned int getNumAgents() const;
-        unsigned int getNumSimple() const;
-        unsigned int getNumStrategic() const;
-        unsigned int getNumResources() const;
+        unsigned int getNumPieces() const { return getNumAgents() + getNumResources(); }
+        unsigned int getNumAgents() const { return getNumSimple() + getNumStrategic(); }
+        unsigned int getNumSimple() const { return __census[SIMPLE]; }
+        unsigned int getNumStrategic() const { return __census[STRATEGIC]; }
+        unsigned int getNumResources() const { return __census[FOOD] + __census[ADVANTAGE]; }
         Status getStatus() const { return __status; }
+        RoundMode getRoundMode() const { return __roundMode; }
+        TurnOrder getTurnOrder() const { return __turnOrder; }
+        unsigned int getNumThreads() const;
         unsigned int getRound() const { return __round; }
+        unsigned int getSeed() const { return __seed; }
+        unsigned int getSpoilClock() const { return __spoilClock; } // spoil steps taken so far
         const Piece *getPiece(unsigned int x, unsigned int y) const;
+        const Piece *pieceAt(unsigned int x, unsigned int y) const; // like getPiece, nullptr if empty
+        unsigned int getMaxId() const { return __idGen; } // largest id given out so far, FIRST_PIECE_ID if none
 
         // grid population methods
         void addSimple(const Position &position);
         void addSimple(const Position &position, double energy); // used for testing only
         void addSimple(unsigned x, unsigned y);
         void addSimple(unsigned x, unsigned y, double energy);
-        void addStrategic(const Position &position, Strategy *s = new DefaultAgentStrategy());
-        void addStrategic(unsigned x, unsigned y, Strategy *s = new DefaultAgentStrategy());
+        // s is adopted by the agent, and deleted if it cannot be placed;
+        // nullptr: the shared DefaultAgentStrategy
+        void addStrategic(const Position &position, Strategy *s = nullptr);
+        void addStrategic(unsigned x, unsigned y, Strategy *s = nullptr);
+        void addStrategic(const Position &position, std::nullptr_t) { addStrategic(position, (Strategy *) nullptr); }
+        void addStrategic(unsigned x, unsigned y, std::nullptr_t) { addStrategic(x, y, (Strategy *) nullptr); }
+        void addStrategic(const Position &position, std::shared_ptr<const Strategy> s); // may be shared by agents
+        void addStrategic(unsigned x, unsigned y, std::shared_ptr<const Strategy> s);
+        void addStrategic(const Position &position, Decision d); // e.g. &PriorityStrategy<...>::decide
+        void addStrategic(unsigned x, unsigned y, Decision d);
         void addFood(const Position &position);
         void addFood(unsigned x, unsigned y);
         void addAdvantage(const Position &position);
         void addAdvantage(unsigned x, unsigned y);
         const Surroundings getSurroundings(const Position &pos) const;
+        SurroundingsKey getSurroundingsKey(const Position &pos) const; // packSurroundings(getSurroundings(pos))
+
+        // add numAgents agents (half Strategic, half Simple) and numResources resources
+        // (half Advantage, half Food) at random empty positions, drawn from the seed;
+        // the counts are clamped to the number of empty positions
+        void populate(unsigned int numAgents, unsigned int numResources);
 
         // gameplay methods
         static const ActionType reachSurroundings(const Position &from, const Position &to); // note: STAY by default
@@ -86,8 +218,35 @@ namespace Gaming {
 
         bool isLegal(const ActionType &ac, const Position &pos) const;
         const Position move(const Position &pos, const ActionType &ac) const; // note: assumes legal, use with isLegal()
+        void setRoundMode(RoundMode mode, unsigned int numThreads = 1);
+        void setTurnOrder(TurnOrder order) { __turnOrder = order; }
         void round();   // play a single round
         void play(bool verbose = false);    // play game until over
+        void play(TerminalRenderer &view);  // play game until over, shown live (see TerminalRenderer)
+        unsigned int simulate(unsigned int maxRounds = 0); // play silently until over or maxRounds (0: no cap), return rounds played
+
+        // call visit(const Piece &) for every piece on the grid, row-major
+        template <class Visitor>
+        void forEachPiece(Visitor visit) const {
+            for (unsigned int i = 0; i < __grid.size(); ++i)
+                if (isPiece(__types[i])) visit(*__grid[i]);
+        }
+
+        // Pieces with a type in who (a typeSet of piece types) and a piece of
+        // a type in what on one of their eight neighbouring squares, e.g. the
+        // agents next to food: countNear(typeSet(SIMPLE, STRATEGIC), typeSet(FOOD))
+        unsigned int countNear(unsigned int who, unsigned int what) const;
+
+        // call visit(const Piece &) for each of those pieces, row-major;
+        // visit must not itself call countNear or forEachNear on this game
+        template <class Visitor>
+        void forEachNear(unsigned int who, unsigned int what, Visitor visit) const {
+            const BitPlane &mask = nearMask(who, what);
+            for (unsigned int r = 0; r < mask.getRows(); ++r)
+                for (unsigned int w = 0; w < mask.getRowWords(); ++w)
+                    for (std::uint64_t word = mask.word(r, w); word; word &= word - 1)
+                        visit(*__grid[r * __stride + w * BitPlane::WORD_BITS + lowestBit(word)]);
+        }
 
 //        const Agent &winner(); // what if no winner or multiple winners?
 
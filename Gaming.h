@@ -6,8 +6,10 @@
 #define PA5GAME_GAMING_H
 
 #include <array>
-#include <random>
+#include <cstdint>
+#include <vector>
 #include "Exceptions.h"
+#include "Random.h"
 
 namespace Gaming {
 
@@ -24,6 +26,12 @@ namespace Gaming {
     // what a position on the game grid can be filled with
     enum PieceType { SIMPLE=0, STRATEGIC, FOOD, ADVANTAGE, INACCESSIBLE, SELF, EMPTY };
 
+    // a set of piece types, e.g. for priority levels that hold more than one
+    constexpr unsigned int typeSet(PieceType type) { return 1u << type; }
+
+    template <class... Types>
+    constexpr unsigned int typeSet(PieceType type, Types... rest) { return (1u << type) | typeSet(rest...); }
+
     // a "map" of the 8 squares adjacent to a piece
     struct Surroundings {
         // encoded as an array/vector top-left row-wise bottom-right
@@ -34,24 +42,71 @@ namespace Gaming {
         std::array<PieceType, 9> array;
     };
 
+    // the same map packed 3 bits per square, square i in bits 3i..3i+2; every
+    // PieceType fits, so keys convert to and from Surroundings losslessly
+    typedef uint32_t SurroundingsKey;
+
+    const unsigned int KEY_CELL_BITS = 3;
+    const SurroundingsKey KEY_CELL_MASK = 07;
+    const SurroundingsKey KEY_LOW_BITS = 0111111111; // lowest bit of each of the 9 squares
+
+    // the motion toward each square of a Surroundings
+    const ActionType CELL_ACTIONS[9] = { NW, N, NE, W, STAY, E, SW, S, SE };
+
+    inline PieceType keyCell(SurroundingsKey key, int i) {
+        return (PieceType) ((key >> (KEY_CELL_BITS * i)) & KEY_CELL_MASK);
+    }
+
+    inline SurroundingsKey packSurroundings(const Surroundings &s) {
+        SurroundingsKey key = 0;
+        for (int i = 0; i < 9; ++i)
+            key |= (SurroundingsKey) s.array[i] << (KEY_CELL_BITS * i);
+        return key;
+    }
+
+    inline Surroundings unpackSurroundings(SurroundingsKey key) {
+        Surroundings s;
+        for (int i = 0; i < 9; ++i)
+            s.array[i] = keyCell(key, i);
+        return s;
+    }
+
+    // 9-bit mask with bit i set if square i holds the given type
+    inline unsigned int keyCells(SurroundingsKey key, PieceType type) {
+        SurroundingsKey diff = key ^ (KEY_LOW_BITS * type); // matching squares become 000
+        SurroundingsKey miss = (diff | diff >> 1 | diff >> 2) & KEY_LOW_BITS;
+        SurroundingsKey hit = ~miss & KEY_LOW_BITS;
+        unsigned int mask = 0;
+        for (int i = 0; i < 9; ++i)
+            mask |= ((hit >> (KEY_CELL_BITS * i)) & 1) << i;
+        return mask;
+    }
+
+    // index of the n-th (from 0) set bit of a nonempty square mask
+    inline int nthCell(unsigned int mask, unsigned int n) {
+        for (; n > 0; --n)
+            mask &= mask - 1;
+        int i = 0;
+        while (!(mask & (1u << i))) ++i;
+        return i;
+    }
+
+    inline unsigned int cellCount(unsigned int mask) {
+        unsigned int n = 0;
+        for (; mask; mask &= mask - 1) ++n;
+        return n;
+    }
+
     class PositionRandomizer {
-        std::default_random_engine __gen;
-        std::uniform_int_distribution<int> *__dist[10];
+        CounterRng __gen;
 
     public:
-        PositionRandomizer() {
-            for (int i = 0; i < 10; i++)
-                __dist[i] = new std::uniform_int_distribution<int>(0, i);
-        }
-
-        ~PositionRandomizer() {
-            for (int i = 0; i < 10; i++) delete __dist[i];
-        }
+        PositionRandomizer() : __gen(0, CounterRng::POSITION, 0, 0) { }
 
         const Position operator()(const std::vector<int> &positionIndices) {
             if (positionIndices.size() == 0) throw PosVectorEmptyEx();
 
-            int posIndex = (*__dist[positionIndices.size() - 1])(__gen);
+            int posIndex = __gen.below((unsigned int) positionIndices.size());
             return Position(
                     (unsigned) (positionIndices[posIndex] / 3),
                     (unsigned) (positionIndices[posIndex] % 3));
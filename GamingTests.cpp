@@ -3,6 +3,7 @@
 //
 
 #include <iostream>
+#include <cmath>
 #include <cassert>
 #include <regex>
 
@@ -13,6 +14,11 @@
 #include "Food.h"
 #include "Advantage.h"
 #include "AggressiveAgentStrategy.h"
+#include "BatchRunner.h"
+#include "DecisionTable.h"
+#include "PriorityStrategy.h"
+#include "NeighborhoodKeys.h"
+#include "TerminalRenderer.h"
 
 using namespace Gaming;
 using namespace Testing;
@@ -24,6 +30,25 @@ using namespace Testing;
 
 // - - - - - - - - - - helper functions - - - - - - - - - -
 
+// same piece types at the same positions, and agents with the same energy
+static bool sameGrid(const Game &a, const Game &b) {
+    if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight()) return false;
+    for (unsigned x = 0; x < a.getHeight(); x++)
+        for (unsigned y = 0; y < a.getWidth(); y++) {
+            const Piece *pa = nullptr, *pb = nullptr;
+            try { pa = a.getPiece(x, y); } catch (PositionEmptyEx &) { }
+            try { pb = b.getPiece(x, y); } catch (PositionEmptyEx &) { }
+            if (!pa || !pb) {
+                if (pa != pb) return false;
+                continue;
+            }
+            if (pa->getType() != pb->getType()) return false;
+            const Agent *aa = dynamic_cast<const Agent *>(pa), *ab = dynamic_cast<const Agent *>(pb);
+            if (aa && aa->getEnergy() != ab->getEnergy()) return false;
+        }
+    return true;
+}
+
 // - - - - - - - - - - local classes - - - - - - - - - -
 
 
@@ -179,10 +204,27 @@ void test_piece_aging(ErrorContext &ec, unsigned int numRuns) {
         }
 
 
+        ec.DESC("resources spoil with the rounds and last one round");
+
+        {
+            Game g;
+            Food f(g, Position(1, 1), 5);
 
-        // TODO test fatigue factor, spoil rate
+            pass = (f.getCapacity() == 5) && f.isViable();
+            double expected = 5;
+            for (int r = 0; r < 3; r++) {
+                g.round();
+                expected /= Resource::RESOURCE_SPOIL_FACTOR;
+                pass = pass && (std::fabs(f.getCapacity() - expected) < 1e-9) && !f.isViable();
+            }
 
+            Food fresh(g, Position(2, 2), 5);
+            fresh.age();
+            pass = pass && (std::fabs(fresh.getCapacity() - 5 / Resource::RESOURCE_SPOIL_FACTOR) < 1e-9) &&
+                   !fresh.isViable();
 
+            ec.result(pass);
+        }
     }
 }
 
@@ -756,6 +798,106 @@ void test_surroundings_smoketest(ErrorContext &ec) {
         if (! pass) std::cout << ss3.str() << std::endl;
     }
     ec.result(pass);
+
+    ec.DESC("packed keys, round trip and agreement with getSurroundings");
+    pass = true;
+    for (int i = 0; i < 10; i ++) {
+        Game g(7, 6, false, (unsigned int) i);
+
+        for (unsigned int x = 0; pass && x < 6; ++x)
+            for (unsigned int y = 0; pass && y < 7; ++y) {
+                Position p(x, y);
+                Surroundings surr = g.getSurroundings(p);
+                SurroundingsKey key = g.getSurroundingsKey(p);
+
+                pass = (key == packSurroundings(surr)) &&
+                       (unpackSurroundings(key).array == surr.array);
+                for (int c = 0; pass && c < 9; ++c)
+                    pass = (keyCell(key, c) == surr.array[c]) &&
+                           (((keyCells(key, surr.array[c]) >> c) & 1) == 1);
+            }
+    }
+    ec.result(pass);
+
+    ec.DESC("decision table, candidates agree with a priority scan");
+    pass = true;
+    {
+        DecisionTable table({ { SIMPLE, STRATEGIC }, { ADVANTAGE }, { EMPTY }, { FOOD } });
+        PieceType levels[4][2] = { { SIMPLE, STRATEGIC }, { ADVANTAGE, ADVANTAGE },
+                                   { EMPTY, EMPTY }, { FOOD, FOOD } };
+        CounterRng rng(0, CounterRng::TURN, 0, 0);
+        for (int i = 0; pass && i < 10000; ++i) {
+            Surroundings surr;
+            for (int c = 0; c < 9; ++c)
+                surr.array[c] = (PieceType) rng.below(EMPTY + 1);
+            surr.array[4] = SELF;
+
+            unsigned int expected = 0;
+            for (int l = 0; expected == 0 && l < 4; ++l)
+                for (int c = 0; c < 9; ++c)
+                    if (surr.array[c] == levels[l][0] || surr.array[c] == levels[l][1])
+                        expected |= 1u << c;
+
+            pass = (table.candidates(packSurroundings(surr)) == expected);
+        }
+    }
+    ec.result(pass);
+
+    ec.DESC("batched decisions agree with one decision per agent");
+    pass = true;
+    {
+        DefaultAgentStrategy byDefault;
+        AggressiveAgentStrategy aggressive(Game::STARTING_AGENT_ENERGY);
+        PriorityStrategy<FOOD, EMPTY> priority;
+        const Strategy *strategies[] = { &byDefault, &aggressive, &priority };
+
+        const unsigned int n = 500;
+        std::vector<SurroundingsKey> keys;
+        CounterRng gen(0, CounterRng::TURN, 0, 0);
+        for (unsigned int k = 0; k < n; ++k) {
+            Surroundings surr;
+            for (int c = 0; c < 9; ++c)
+                surr.array[c] = (PieceType) gen.below(EMPTY + 1);
+            surr.array[4] = SELF;
+            keys.push_back(packSurroundings(surr));
+        }
+
+        for (const Strategy *strategy : strategies) {
+            std::vector<CounterRng> rngs;
+            for (unsigned int k = 0; k < n; ++k)
+                rngs.push_back(CounterRng(7, CounterRng::TURN, k, 3));
+            std::vector<ActionType> actions(n);
+            strategy->decideBatch(keys.data(), rngs.data(), actions.data(), n);
+
+            for (unsigned int k = 0; pass && k < n; ++k) {
+                CounterRng rng(7, CounterRng::TURN, k, 3);
+                pass = (actions[k] == (*strategy)(unpackSurroundings(keys[k]), rng));
+            }
+        }
+    }
+    ec.result(pass);
+
+    ec.DESC(std::string("row of neighborhood keys (") + neighborhoodKeysKernel() + ")");
+    pass = true;
+    {
+        const unsigned int n = 37; // whole vectors and a tail
+        std::vector<unsigned char> rows[3];
+        for (int r = 0; r < 3; ++r)
+            for (unsigned int i = 0; i < n + 2; ++i)
+                rows[r].push_back((unsigned char) ((i * 5 + r * 3 + i / 7) % (EMPTY + 1)));
+        std::vector<SurroundingsKey> keys(n);
+        neighborhoodKeys(&rows[0][1], &rows[1][1], &rows[2][1], n, keys.data());
+
+        for (unsigned int i = 0; pass && i < n; ++i) {
+            Surroundings surr;
+            for (int r = 0; r < 3; ++r)
+                for (int c = 0; c < 3; ++c)
+                    surr.array[r * 3 + c] = (PieceType) rows[r][i + c];
+            surr.array[4] = SELF;
+            pass = (keys[i] == packSurroundings(surr));
+        }
+    }
+    ec.result(pass);
 }
 
 
@@ -925,6 +1067,37 @@ void test_game_smoketest(ErrorContext &ec) {
         }
     }
     ec.result(pass);
+
+    ec.DESC("strategies, shared default and shared/released ownership");
+    pass = true;
+    for (int i = 0; i < 10; i ++) {
+        std::shared_ptr<const Strategy> aggressive(new AggressiveAgentStrategy(Game::STARTING_AGENT_ENERGY));
+        {
+            Game g(9, 9, false);
+            g.forEachPiece([&](const Piece &piece) {
+                if (piece.getType() == STRATEGIC)
+                    pass = pass && (static_cast<const Agent &>(piece).getStrategy() ==
+                                    DefaultAgentStrategy::shared().get());
+            });
+
+            Game m(4, 4);
+            m.addStrategic(0, 0, aggressive);
+            m.addStrategic(1, 1, aggressive);
+            m.addStrategic(2, 2, nullptr);
+            m.addStrategic(Position(3, 3), nullptr);
+            pass = pass && (aggressive.use_count() == 3) &&
+                   (static_cast<const Agent *>(m.getPiece(2, 2))->getStrategy() == DefaultAgentStrategy::shared().get()) &&
+                   (static_cast<const Agent *>(m.getPiece(3, 3))->getStrategy() == DefaultAgentStrategy::shared().get());
+            try {
+                m.addStrategic(1, 1, aggressive);
+                pass = false;
+            } catch (PositionNonemptyEx &ex) {
+                pass = pass && (aggressive.use_count() == 3);
+            }
+        }
+        pass = pass && (aggressive.use_count() == 1);
+    }
+    ec.result(pass);
 }
 
 // populate the game grid
@@ -1336,6 +1509,86 @@ void test_game_print(ErrorContext &ec, unsigned int numRuns) {
 
             ec.result(pass);
         }
+
+        ec.DESC("120x100 grid, cells as the pieces print themselves");
+
+        {
+            Game g(120, 100, false); // ids past 9999
+            const char *statusText[] = { "Not Started...", "Playing...", "Over!" };
+            auto board = [&]() {
+                std::stringstream expected;
+                expected << "Round " << g.getRound() << std::endl;
+                for (unsigned int x = 0; x < g.getHeight(); x++) {
+                    for (unsigned int y = 0; y < g.getWidth(); y++) {
+                        try {
+                            const Piece *piece = g.getPiece(x, y);
+                            expected << '[' << *piece << ']';
+                        } catch (PositionEmptyEx &) {
+                            expected << "[     ]";
+                        }
+                    }
+                    expected << std::endl;
+                }
+                expected << "Status: " << statusText[g.getStatus()] << std::endl;
+                return expected.str();
+            };
+
+            // the status line goes to the stream too, none of it to cout
+            std::stringstream ss, out;
+            std::streambuf *coutBuf = std::cout.rdbuf(out.rdbuf());
+            ss << g;
+            pass = (ss.str() == board());
+            g.simulate(1);
+            ss.str("");
+            ss << g;
+            std::cout.rdbuf(coutBuf);
+            pass = pass && (g.getStatus() != Game::NOT_STARTED) && (ss.str() == board()) && out.str().empty();
+
+            ec.result(pass);
+        }
+
+        ec.DESC("40x30 grid, live view redraws only changed cells");
+
+        {
+            Game g(40, 30); // a few agents, which move each round
+            for (unsigned int x = 0; x < 30; x += 5)
+                for (unsigned int y = 0; y < 40; y += 5)
+                    g.addSimple(x, y);
+            std::stringstream ss, slowSs;
+            TerminalRenderer view(ss, 0); // no rate limit
+            TerminalRenderer slow(slowSs, 1);
+
+            pass = view.draw(g) && slow.draw(g);
+            std::string::size_type first = ss.str().size();
+            pass = pass && !view.draw(g) && (ss.str().size() == first); // nothing changed
+
+            g.round();
+            pass = pass && view.draw(g) && !slow.draw(g) && slow.draw(g, true);
+
+            std::stringstream full;
+            TerminalRenderer fresh(full, 0);
+            fresh.draw(g);
+            pass = pass && (ss.str().size() > first) && (ss.str().size() - first < full.str().size() / 2);
+
+            ec.result(pass);
+        }
+
+        ec.DESC("cell query and max id");
+
+        {
+            Game g(3, 3);
+            pass = (g.pieceAt(1, 1) == nullptr) && (g.getMaxId() == Game::FIRST_PIECE_ID);
+            g.addSimple(1, 1);
+            g.addFood(2, 0);
+            pass = pass && (g.pieceAt(1, 1) == g.getPiece(1, 1)) && (g.pieceAt(2, 0)->getType() == FOOD)
+                   && (g.getMaxId() == g.pieceAt(2, 0)->getId());
+            try {
+                g.pieceAt(3, 0);
+                pass = false;
+            } catch (OutOfBoundsEx &) { }
+
+            ec.result(pass);
+        }
     }
 }
 
@@ -1648,6 +1901,232 @@ void test_game_play(ErrorContext &ec, unsigned int numRuns) {
 
             ec.result(pass);
         }
+
+        ec.DESC("6x6 grid, manual, priority template plays like the default strategy");
+
+        {
+            Game gv(6, 6), gt(6, 6);
+            for (unsigned int k = 0; k < 6; ++k) {
+                gv.addStrategic(k, k);
+                gt.addStrategic(k, k, &PriorityStrategy<ADVANTAGE, FOOD, EMPTY, SIMPLE>::decide);
+                gv.addSimple(k, (k + 3) % 6); gt.addSimple(k, (k + 3) % 6);
+                gv.addFood(k, (k + 1) % 6); gt.addFood(k, (k + 1) % 6);
+                gv.addAdvantage((k + 2) % 6, k); gt.addAdvantage((k + 2) % 6, k);
+            }
+
+            pass = sameGrid(gv, gt);
+            for (int r = 0; pass && r < 5 && gv.getStatus() != Game::OVER; ++r) {
+                gv.simulate(1);
+                gt.simulate(1);
+                pass = sameGrid(gv, gt);
+            }
+
+            ec.result(pass);
+        }
+
+        ec.DESC("12x10 grid, auto, serial turn orders replay identically");
+
+        {
+            Game::TurnOrder orders[] = { Game::ID_ORDER, Game::GRID_ORDER, Game::SHUFFLED };
+            Game *played[3];
+            pass = true;
+            for (int k = 0; k < 3; ++k) {
+                Game again(12, 10, false, 7);
+                played[k] = new Game(12, 10, false, 7);
+                played[k]->setTurnOrder(orders[k]);
+                again.setTurnOrder(orders[k]);
+                played[k]->simulate(1);
+                again.simulate(1);
+                pass = pass && (played[k]->getTurnOrder() == orders[k]) && sameGrid(*played[k], again);
+            }
+            pass = pass && !sameGrid(*played[0], *played[2]);
+            for (int k = 0; k < 3; ++k) delete played[k];
+
+            ec.result(pass);
+        }
     }
 }
 
+// Parallel (tiled) rounds
+void test_game_parallel(ErrorContext &ec, unsigned int numRuns) {
+    bool pass;
+
+    // Run at least once!!
+    assert(numRuns > 0);
+
+    ec.DESC("--- Test - Game - Parallel rounds ---");
+
+    for (int run = 0; run < numRuns; run++) {
+
+        ec.DESC("tiled rounds, 1 vs 4 threads give the same grid");
+
+        {
+            Game g1(100, 70, false), g4(100, 70, false);
+            g1.setRoundMode(Game::TILED, 1);
+            g4.setRoundMode(Game::TILED, 4);
+
+            pass = (g4.getNumThreads() == 4) && sameGrid(g1, g4);
+            for (int i = 0; i < 5; i++) {
+                g1.round();
+                g4.round();
+                pass = pass && sameGrid(g1, g4) &&
+                       (g1.getNumPieces() == g4.getNumPieces());
+            }
+
+            ec.result(pass);
+        }
+
+        ec.DESC("intent rounds, 1 vs 4 threads give the same grid");
+
+        {
+            Game g1(100, 70, false), g4(100, 70, false);
+            g1.setRoundMode(Game::INTENT, 1);
+            g4.setRoundMode(Game::INTENT, 4);
+
+            pass = true;
+            for (int i = 0; i < 5; i++) {
+                g1.round();
+                g4.round();
+                pass = pass && sameGrid(g1, g4) &&
+                       (g1.getNumPieces() == g4.getNumPieces());
+            }
+
+            ec.result(pass);
+        }
+
+        ec.DESC("tiled rounds, neighborhood queries match the surroundings");
+
+        {
+            Game g(150, 40, false);
+            g.setRoundMode(Game::TILED, 4);
+            const unsigned int agents = typeSet(SIMPLE, STRATEGIC);
+
+            pass = true;
+            for (int i = 0; i < 3; i++) {
+                unsigned int nearFood = 0, nearAgents = 0, visited = 0;
+                g.forEachPiece([&](const Piece &piece) {
+                    if (piece.getType() != SIMPLE && piece.getType() != STRATEGIC) return;
+                    Surroundings s = g.getSurroundings(piece.getPosition());
+                    bool food = false, agent = false;
+                    for (int k = 0; k < 9; ++k) {
+                        food = food || s.array[k] == FOOD;
+                        agent = agent || s.array[k] == SIMPLE || s.array[k] == STRATEGIC;
+                    }
+                    nearFood += food;
+                    nearAgents += agent;
+                });
+                g.forEachNear(agents, typeSet(FOOD), [&](const Piece &piece) {
+                    Surroundings s = g.getSurroundings(piece.getPosition());
+                    visited += (std::find(s.array.begin(), s.array.end(), FOOD) != s.array.end());
+                });
+                pass = pass && (nearAgents > 0) &&
+                       (g.countNear(agents, typeSet(FOOD)) == nearFood) && (visited == nearFood) &&
+                       (g.countNear(agents, agents) == nearAgents);
+                if (i == 0) pass = pass && (nearFood > 0);
+                g.round();
+            }
+
+            ec.result(pass);
+        }
+
+        ec.DESC("intent rounds, stronger agent wins a contested cell");
+
+        {
+            Game g; // manual = true, by default
+            g.addSimple(0, 0, 50);
+            g.addFood(0, 1);
+            g.addSimple(0, 2, 30);
+            g.setRoundMode(Game::INTENT);
+
+            g.round();
+
+            const Agent *winner = dynamic_cast<const Agent *>(g.getPiece(0, 1));
+            const Agent *loser = dynamic_cast<const Agent *>(g.getPiece(0, 2));
+
+            pass = winner && loser &&
+                   (winner->getEnergy() > 50 - Agent::AGENT_FATIGUE_RATE) &&
+                   (loser->getEnergy() == 30 - Agent::AGENT_FATIGUE_RATE) &&
+                   (g.getNumResources() == 0);
+
+            ec.result(pass);
+        }
+
+        ec.DESC("tiled rounds, grid smaller than a tile");
+
+        {
+            Game g; // manual = true, by default
+            g.addSimple(1, 1);
+            g.addFood(2, 2);
+            g.setRoundMode(Game::TILED, 3);
+
+            g.simulate(); // until over, printing nothing
+
+            pass = (g.getNumResources() == 0) &&
+                   (g.getNumAgents() == 1);
+
+            ec.result(pass);
+        }
+    }
+}
+
+
+// - - - - - - - - - - B A T C H - - - - - - - - - -
+
+// Batches of independent games
+void test_batch_runner(ErrorContext &ec, unsigned int numRuns) {
+    bool pass;
+
+    // Run at least once!!
+    assert(numRuns > 0);
+
+    ec.DESC("--- Test - Batch - Runner ---");
+
+    for (int run = 0; run < numRuns; run++) {
+
+        ec.DESC("12x9 grids, 40 games, same stats on 1 and 4 threads");
+
+        {
+            BatchConfig config(12, 9, 40);
+            config.firstSeed = 100;
+
+            BatchStats s1 = BatchRunner(1).run(config);
+            BatchStats s4 = BatchRunner(4).run(config);
+
+            pass = (s1.games.size() == 40) &&
+                   (s1.numOver == s4.numOver) &&
+                   (s1.meanRounds == s4.meanRounds) &&
+                   (s1.meanSimple == s4.meanSimple) &&
+                   (s1.meanStrategic == s4.meanStrategic) &&
+                   (s1.numSurvivors == s4.numSurvivors) &&
+                   (s1.meanEnergy == s4.meanEnergy) &&
+                   (s1.medianEnergy == s4.medianEnergy);
+            for (unsigned i = 0; pass && i < s1.games.size(); i++)
+                pass = (s1.games[i].seed == 100 + i) &&
+                       (s1.games[i].rounds == s4.games[i].rounds) &&
+                       (s1.games[i].numSimple == s4.games[i].numSimple);
+
+            ec.result(pass);
+        }
+
+        ec.DESC("batch games default to serial rounds");
+
+        {
+            BatchConfig config;
+            pass = (config.roundMode == Game::SERIAL);
+
+            ec.result(pass);
+        }
+
+        ec.DESC("different seeds give different initial grids");
+
+        {
+            Game g0(9, 9, false, 0), g1(9, 9, false, 1), g0again(9, 9, false, 0);
+
+            pass = !sameGrid(g0, g1) && sameGrid(g0, g0again) &&
+                   (g1.getNumAgents() == 20) &&
+                   (g1.getNumResources() == 40);
+
+            ec.result(pass);
+        }
+    }
+}
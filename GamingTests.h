@@ -64,4 +64,13 @@ void test_game_randomization(ErrorContext &ec, unsigned int numRuns);
 // Playing and termination of a game
 void test_game_play(ErrorContext &ec, unsigned int numRuns);
 
+// Parallel (tiled) rounds
+void test_game_parallel(ErrorContext &ec, unsigned int numRuns);
+
+
+// - - - - - - - - - Tests: class BatchRunner - - - - - - - - - -
+
+// Batches of independent games
+void test_batch_runner(ErrorContext &ec, unsigned int numRuns);
+
 #endif //PA5GAME_GAMINGTESTS_H
@@ -0,0 +1,122 @@
+#include <cstring>
+#include "NeighborhoodKeys.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace Gaming {
+
+    // A key is three columns of three squares side by side. A column's
+    // squares sit 3 * KEY_CELL_BITS apart, and the columns KEY_CELL_BITS
+    // apart, so every column is packed once and reused by the three keys
+    // whose window covers it.
+    static const unsigned int ROW_BITS = 3 * KEY_CELL_BITS;
+    static const SurroundingsKey CENTER_MASK = KEY_CELL_MASK << (4 * KEY_CELL_BITS);
+    static const SurroundingsKey CENTER_SELF = (SurroundingsKey) SELF << (4 * KEY_CELL_BITS);
+
+    static SurroundingsKey column(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                                  int i) {
+        return (SurroundingsKey) above[i] | (SurroundingsKey) row[i] << ROW_BITS
+               | (SurroundingsKey) below[i] << (2 * ROW_BITS);
+    }
+
+    static void scalarKeys(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                           unsigned int begin, unsigned int end, SurroundingsKey *keys) {
+        if (begin >= end) return;
+        SurroundingsKey left = column(above, row, below, (int) begin - 1);
+        SurroundingsKey mid = column(above, row, below, (int) begin);
+        for (unsigned int i = begin; i < end; ++i) {
+            SurroundingsKey right = column(above, row, below, (int) i + 1);
+            keys[i] = ((left | mid << KEY_CELL_BITS | right << (2 * KEY_CELL_BITS)) & ~CENTER_MASK) | CENTER_SELF;
+            left = mid;
+            mid = right;
+        }
+    }
+
+#if defined(__AVX2__)
+
+    static const unsigned int LANES = 8;
+
+    // the eight squares at p, widened to 32 bits
+    static __m256i widen(const unsigned char *p) {
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p)));
+    }
+
+    static __m256i columns(const unsigned char *above, const unsigned char *row, const unsigned char *below) {
+        return _mm256_or_si256(widen(above), _mm256_or_si256(_mm256_slli_epi32(widen(row), ROW_BITS),
+                                                             _mm256_slli_epi32(widen(below), 2 * ROW_BITS)));
+    }
+
+    static unsigned int vectorKeys(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                                   unsigned int n, SurroundingsKey *keys) {
+        const __m256i centerMask = _mm256_set1_epi32((int) ~CENTER_MASK);
+        const __m256i centerSelf = _mm256_set1_epi32((int) CENTER_SELF);
+        unsigned int i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            __m256i left = columns(above + i - 1, row + i - 1, below + i - 1);
+            __m256i mid = columns(above + i, row + i, below + i);
+            __m256i right = columns(above + i + 1, row + i + 1, below + i + 1);
+            __m256i key = _mm256_or_si256(left, _mm256_or_si256(_mm256_slli_epi32(mid, KEY_CELL_BITS),
+                                                                _mm256_slli_epi32(right, 2 * KEY_CELL_BITS)));
+            key = _mm256_or_si256(_mm256_and_si256(key, centerMask), centerSelf);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(keys + i), key);
+        }
+        return i;
+    }
+
+    const char *neighborhoodKeysKernel() { return "avx2"; }
+
+#elif defined(__SSE2__)
+
+    static const unsigned int LANES = 4;
+
+    // the four squares at p, widened to 32 bits
+    static __m128i widen(const unsigned char *p) {
+        int bytes;
+        std::memcpy(&bytes, p, sizeof bytes);
+        const __m128i zero = _mm_setzero_si128();
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+    }
+
+    static __m128i columns(const unsigned char *above, const unsigned char *row, const unsigned char *below) {
+        return _mm_or_si128(widen(above), _mm_or_si128(_mm_slli_epi32(widen(row), ROW_BITS),
+                                                       _mm_slli_epi32(widen(below), 2 * ROW_BITS)));
+    }
+
+    static unsigned int vectorKeys(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                                   unsigned int n, SurroundingsKey *keys) {
+        const __m128i centerMask = _mm_set1_epi32((int) ~CENTER_MASK);
+        const __m128i centerSelf = _mm_set1_epi32((int) CENTER_SELF);
+        unsigned int i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            __m128i left = columns(above + i - 1, row + i - 1, below + i - 1);
+            __m128i mid = columns(above + i, row + i, below + i);
+            __m128i right = columns(above + i + 1, row + i + 1, below + i + 1);
+            __m128i key = _mm_or_si128(left, _mm_or_si128(_mm_slli_epi32(mid, KEY_CELL_BITS),
+                                                          _mm_slli_epi32(right, 2 * KEY_CELL_BITS)));
+            key = _mm_or_si128(_mm_and_si128(key, centerMask), centerSelf);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(keys + i), key);
+        }
+        return i;
+    }
+
+    const char *neighborhoodKeysKernel() { return "sse2"; }
+
+#else
+
+    static unsigned int vectorKeys(const unsigned char *, const unsigned char *, const unsigned char *,
+                                   unsigned int, SurroundingsKey *) {
+        return 0;
+    }
+
+    const char *neighborhoodKeysKernel() { return "scalar"; }
+
+#endif
+
+    void neighborhoodKeys(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                          unsigned int n, SurroundingsKey *keys) {
+        scalarKeys(above, row, below, vectorKeys(above, row, below, n, keys), n, keys);
+    }
+
+}
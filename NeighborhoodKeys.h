@@ -0,0 +1,24 @@
+//
+// Packed neighborhoods of whole rows of a padded type plane.
+//
+
+#ifndef PA5GAME_NEIGHBORHOODKEYS_H
+#define PA5GAME_NEIGHBORHOODKEYS_H
+
+#include "Gaming.h"
+
+namespace Gaming {
+
+    // keys[i] = the SurroundingsKey of row[i], for i < n, with SELF in the
+    // middle. above and below point at the same columns of the rows on
+    // either side, and one cell is read past each end of all three rows
+    // (a padded plane has them).
+    void neighborhoodKeys(const unsigned char *above, const unsigned char *row, const unsigned char *below,
+                          unsigned int n, SurroundingsKey *keys);
+
+    // the instruction set neighborhoodKeys() was built for: "avx2", "sse2" or "scalar"
+    const char *neighborhoodKeysKernel();
+
+}
+
+#endif //PA5GAME_NEIGHBORHOODKEYS_H
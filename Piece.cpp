@@ -1,17 +1,20 @@
 #include "Game.h"
 #include "Piece.h"
+#include "Simple.h"
+#include "Strategic.h"
+#include "Food.h"
+#include "Advantage.h"
 #include <iostream>
 
 using namespace std;
 
 namespace Gaming {
 
-    unsigned int Piece::__idGen = 1000;
     Piece::Piece(const Game &g, const Position &p): __game(g) {
         __position = p;
         __finished = false;
         __turned = false;
-        __id = ++__idGen;
+        __id = ++g.__idGen;
     }
 
     Piece::~Piece() {
@@ -23,4 +26,20 @@ namespace Gaming {
         return os;
     }
 
+    void appendNumber(string &s, unsigned int n) {
+        char digits[16], *p = digits + sizeof digits;
+        do {
+            *--p = (char) ('0' + n % 10);
+            n /= 10;
+        } while (n != 0);
+        s.append(p, digits + sizeof digits);
+    }
+
+    void appendLabel(string &s, PieceType type, unsigned int id) {
+        static const char LETTERS[ADVANTAGE + 1] = { Simple::SIMPLE_ID, Strategic::STRATEGIC_ID, Food::FOOD_ID,
+                                                     Advantage::ADVANTAGE_ID };
+        s.push_back(LETTERS[type]);
+        appendNumber(s, id);
+    }
+
 }
\ No newline at end of file
@@ -16,8 +16,6 @@ namespace Gaming {
     class Piece {
 
     private:
-        static unsigned int __idGen;
-
         bool __finished;
         bool __turned;
 
@@ -36,6 +34,8 @@ namespace Gaming {
         Piece(const Game &g, const Position &p);
         virtual ~Piece();
 
+        unsigned int getId() const { return __id; }
+
         const Position getPosition() const { return __position; }
         void setPosition(const Position &p) { __position = p; }
 
@@ -54,6 +54,15 @@ namespace Gaming {
 
         friend std::ostream &operator<<(std::ostream &os, const Piece &piece);
     };
+
+    // board labels, as the pieces print themselves: the letter of the type, then the id
+    void appendNumber(std::string &s, unsigned int n); // decimal digits of n
+    void appendLabel(std::string &s, PieceType type, unsigned int id);
+    inline unsigned int labelWidth(unsigned int id) {
+        unsigned int width = 2;
+        for (; id >= 10; id /= 10) ++width;
+        return width;
+    }
 }
 
 
@@ -0,0 +1,82 @@
+//
+// Typed slab allocator for the pieces owned by a Game.
+//
+
+#ifndef PA5GAME_PIECEPOOL_H
+#define PA5GAME_PIECEPOOL_H
+
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Gaming {
+
+    // Hands out T-sized slots carved from fixed-size slabs. Destroyed objects
+    // go on an intrusive free list and their slots are reused by the next
+    // create(). Slabs are only returned to the system when the pool dies, so
+    // every object must have been destroyed by then.
+    template <class T>
+    class PiecePool {
+    public:
+        static const unsigned int SLAB_SIZE = 256; // objects per slab
+
+    private:
+        struct FreeSlot { FreeSlot *next; };
+
+        std::vector<char *> __slabs;
+        FreeSlot *__free;
+        unsigned int __used; // slots handed out from the last slab
+
+        static std::size_t slotSize() {
+            return sizeof(T) < sizeof(FreeSlot) ? sizeof(FreeSlot) : sizeof(T);
+        }
+
+        void *allocate() {
+            if (__free) {
+                void *slot = __free;
+                __free = __free->next;
+                return slot;
+            }
+            if (__slabs.empty() || __used == SLAB_SIZE) {
+                __slabs.push_back(static_cast<char *>(::operator new(SLAB_SIZE * slotSize())));
+                __used = 0;
+            }
+            return __slabs.back() + slotSize() * __used++;
+        }
+
+        void release(void *slot) {
+            FreeSlot *f = static_cast<FreeSlot *>(slot);
+            f->next = __free;
+            __free = f;
+        }
+
+    public:
+        PiecePool() : __free(nullptr), __used(0) { }
+        PiecePool(const PiecePool &) = delete;
+        PiecePool &operator=(const PiecePool &) = delete;
+
+        ~PiecePool() {
+            for (auto it = __slabs.begin(); it != __slabs.end(); ++it)
+                ::operator delete(*it);
+        }
+
+        template <class... Args>
+        T *create(Args &&... args) {
+            void *slot = allocate();
+            try {
+                return new (slot) T(std::forward<Args>(args)...);
+            } catch (...) {
+                release(slot);
+                throw;
+            }
+        }
+
+        void destroy(T *obj) {
+            obj->~T();
+            release(obj);
+        }
+    };
+
+}
+
+#endif //PA5GAME_PIECEPOOL_H
@@ -0,0 +1,75 @@
+//
+// Priority strategies composed at compile time.
+//
+
+#ifndef PA5GAME_PRIORITYSTRATEGY_H
+#define PA5GAME_PRIORITYSTRATEGY_H
+
+#include "Strategy.h"
+
+namespace Gaming {
+
+    // squares of a key holding any type of the set; unrolls for a constant set
+    inline unsigned int keyCellsIn(SurroundingsKey key, unsigned int types) {
+        unsigned int cells = 0;
+        for (int t = SIMPLE; t <= EMPTY; ++t)
+            if (types & (1u << t)) cells |= keyCells(key, (PieceType) t);
+        return cells;
+    }
+
+    template <unsigned int... Levels>
+    struct PriorityRule;
+
+    template <>
+    struct PriorityRule<> {
+        static unsigned int candidates(SurroundingsKey) { return 0; }
+    };
+
+    template <unsigned int Level, unsigned int... Rest>
+    struct PriorityRule<Level, Rest...> {
+        static unsigned int candidates(SurroundingsKey key) {
+            unsigned int cells = keyCellsIn(key, Level);
+            return cells != 0 ? cells : PriorityRule<Rest...>::candidates(key);
+        }
+    };
+
+    // Moves to a random square on the first level (a typeSet) that has any,
+    // or stays. decide() is a plain function with the whole rule inlined:
+    // Strategic agents can hold it as a Decision, with no Strategy object.
+    template <unsigned int... Levels>
+    class PriorityLevelStrategy : public Strategy {
+    public:
+        static ActionType decide(SurroundingsKey key, CounterRng &rng) {
+            unsigned int cells = PriorityRule<Levels...>::candidates(key);
+            if (cells == 0) return STAY;
+            return CELL_ACTIONS[nthCell(cells, rng.below(cellCount(cells)))];
+        }
+
+        ActionType operator()(const Surroundings &s) const override {
+            static thread_local CounterRng rng(0, CounterRng::TURN, 0, 0);
+            return decide(packSurroundings(s), rng);
+        }
+
+        ActionType operator()(const Surroundings &s, CounterRng &rng) const override {
+            return decide(packSurroundings(s), rng);
+        }
+
+        ActionType operator()(SurroundingsKey key, CounterRng &rng) const override {
+            return decide(key, rng);
+        }
+
+        void decideBatch(const SurroundingsKey *keys, CounterRng *rngs,
+                         ActionType *actions, unsigned int n) const override {
+            for (unsigned int k = 0; k < n; ++k)
+                actions[k] = decide(keys[k], rngs[k]);
+        }
+    };
+
+    // one piece type per level, e.g. PriorityStrategy<ADVANTAGE, FOOD, EMPTY, SIMPLE>
+    // decides like DefaultAgentStrategy
+    template <PieceType... Types>
+    using PriorityStrategy = PriorityLevelStrategy<typeSet(Types)...>;
+
+}
+
+#endif //PA5GAME_PRIORITYSTRATEGY_H
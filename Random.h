@@ -0,0 +1,77 @@
+//
+// Counter-based random number generation for the game.
+//
+
+#ifndef PA5GAME_RANDOM_H
+#define PA5GAME_RANDOM_H
+
+#include <cstdint>
+
+namespace Gaming {
+
+    // Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+    // The output is a pure function of a 64-bit key and a 128-bit counter, so a
+    // generator costs nothing to create, needs no shared state and gives the
+    // same numbers on any thread. The game keys it with its seed and builds the
+    // counter from (stream, piece id, round), giving each piece an independent,
+    // reproducible sequence every round.
+    class CounterRng {
+    public:
+        typedef std::uint32_t result_type;
+
+        // independent families of draws under the same key
+        enum Stream { TURN = 0, POSITION, POPULATE, SCHEDULE };
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    private:
+        std::uint32_t __key[2];
+        std::uint32_t __counter[4];
+        std::uint32_t __block[4];
+        unsigned int __used; // words of __block already returned
+
+        static void philox(std::uint32_t ctr[4], std::uint32_t k0, std::uint32_t k1) {
+            for (int r = 0; r < 10; ++r) {
+                std::uint64_t p0 = (std::uint64_t) 0xD2511F53u * ctr[0];
+                std::uint64_t p1 = (std::uint64_t) 0xCD9E8D57u * ctr[2];
+                std::uint32_t c0 = (std::uint32_t) (p1 >> 32) ^ ctr[1] ^ k0;
+                std::uint32_t c2 = (std::uint32_t) (p0 >> 32) ^ ctr[3] ^ k1;
+                ctr[1] = (std::uint32_t) p1;
+                ctr[3] = (std::uint32_t) p0;
+                ctr[0] = c0;
+                ctr[2] = c2;
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+        }
+
+    public:
+        CounterRng(std::uint64_t seed, Stream stream, std::uint32_t id, std::uint32_t round) : __used(4) {
+            __key[0] = (std::uint32_t) seed;
+            __key[1] = (std::uint32_t) (seed >> 32);
+            __counter[0] = 0;
+            __counter[1] = round;
+            __counter[2] = id;
+            __counter[3] = (std::uint32_t) stream;
+        }
+
+        result_type operator()() {
+            if (__used == 4) {
+                for (int i = 0; i < 4; ++i) __block[i] = __counter[i];
+                philox(__block, __key[0], __key[1]);
+                ++__counter[0];
+                __used = 0;
+            }
+            return __block[__used++];
+        }
+
+        // uniform in [0, n), n > 0 (multiply-shift, bias below 2^-32 * n)
+        unsigned int below(unsigned int n) {
+            return (unsigned int) (((std::uint64_t) (*this)() * n) >> 32);
+        }
+    };
+
+}
+
+#endif //PA5GAME_RANDOM_H
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include "Piece.h"
 #include "Resource.h"
 #include "Game.h"
@@ -7,22 +9,49 @@ using namespace std;
 namespace Gaming {
     
     const double Resource::RESOURCE_SPOIL_FACTOR = 1.2;
+    const double Resource::SPOIL_THRESHOLD = 0.001;
+    const unsigned int Resource::RESOURCE_LIFETIME = 1; // whoops: resources only ever lasted one round
 
-    Resource::Resource(const Game &g, const Position &p, double capacity) : Piece (g, p) { __capacity = capacity; }
+    Resource::Resource(const Game &g, const Position &p, double capacity) : Piece (g, p) {
+        __capacity = capacity;
+        __touched = __born = g.getSpoilClock();
+    }
 
     Resource::~Resource() { }
 
+    void Resource::setCapacity(double capacity) {
+        __capacity = capacity;
+        __touched = __game.getSpoilClock();
+    }
+
+    double Resource::getCapacity() const {
+        unsigned int elapsed = __game.getSpoilClock() - __touched;
+        if (elapsed == 0)
+            return __capacity;
+        double capacity = __capacity / pow(RESOURCE_SPOIL_FACTOR, (double) elapsed);
+        return capacity < SPOIL_THRESHOLD ? 0 : capacity;
+    }
+
     double Resource::consume() {
-        double omnomnom = __capacity;
-        __capacity = -1;
+        double omnomnom = getCapacity();
+        setCapacity(-1);
         finish();
         return omnomnom;
     }
 
+    unsigned int Resource::getExpiry() const {
+        unsigned int steps = 0; // spoil steps from __touched until the capacity drops below SPOIL_THRESHOLD
+        if (__capacity >= SPOIL_THRESHOLD)
+            steps = (unsigned int) (log(__capacity / SPOIL_THRESHOLD) / log(RESOURCE_SPOIL_FACTOR)) + 1;
+        else if (__capacity > 0)
+            steps = 1;
+        unsigned int lived = min(__touched - __born, RESOURCE_LIFETIME);
+        return __touched + min(steps, RESOURCE_LIFETIME - lived);
+    }
+
     void Resource::age() {
-        __capacity /= RESOURCE_SPOIL_FACTOR;
-        if (__capacity < 0.001)
-            __capacity = 0;
+        double capacity = getCapacity() / RESOURCE_SPOIL_FACTOR;
+        setCapacity(capacity < SPOIL_THRESHOLD ? 0 : capacity);
         finish(); // whoops
     }
 
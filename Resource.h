@@ -12,21 +12,37 @@ namespace Gaming {
 
     class Resource : public Piece {
 
-    protected:
+    private:
+        // Spoiling is lazy: the capacity is stored as of a reading of the
+        // game's spoil clock, and getCapacity() applies the spoil steps taken
+        // since in closed form.
         double __capacity;
-        
+        unsigned int __touched; // spoil clock when __capacity was set
+        unsigned int __born;    // spoil clock at creation
+
+    protected:
+        void setCapacity(double capacity);
+
     public:
         static const double RESOURCE_SPOIL_FACTOR;
+        static const double SPOIL_THRESHOLD;       // spoiling below this leaves nothing
+        static const unsigned int RESOURCE_LIFETIME; // spoil steps a resource lasts
 
         Resource(const Game &g, const Position &p, double capacity);
         ~Resource();
 
-        virtual double getCapacity() const { return __capacity; }
+        virtual double getCapacity() const;
         virtual double consume();
 
-        void age() override final;
+        // spoil clock reading at which the resource is no longer viable unless
+        // consumed earlier
+        unsigned int getExpiry() const;
+
+        void age() override final; // one extra spoil step, right now
 
-        bool isViable() const override final { return !isFinished() && __capacity > 0.0; }
+        bool isViable() const override final {
+            return !isFinished() && __game.getSpoilClock() - __born < RESOURCE_LIFETIME && getCapacity() > 0.0;
+        }
 
         ActionType takeTurn(const Surroundings &s) const override;
 
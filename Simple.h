@@ -7,14 +7,19 @@
 
 #include "Game.h"
 #include "Agent.h"
+#include "PriorityStrategy.h"
 
 namespace Gaming {
 
     class Simple : public Agent {
     private:
-        static const char SIMPLE_ID;
+        // resources first, else any empty square
+        typedef PriorityLevelStrategy<typeSet(ADVANTAGE, FOOD), typeSet(EMPTY)> Rule;
+        static const Rule STRATEGY;
 
     public:
+        static const char SIMPLE_ID;
+
         Simple(const Game &g, const Position &p, double energy);
         ~Simple();
 
@@ -24,6 +29,8 @@ namespace Gaming {
 
         ActionType takeTurn(const Surroundings &s) const override;
 
+        const Strategy *getStrategy() const override { return &STRATEGY; }
+
     };
 }
 
@@ -0,0 +1,139 @@
+//
+// Headless simulation runner.
+//
+// usage: ucd-csci2312-pa4-sim [--width N] [--height N] [--density D] [--seed N]
+//                             [--rounds N] [--threads N] [--mode serial|tiled|intent]
+//                             [--order id|grid|shuffled] [--output none|final|every|live]
+//                             [--fps N]
+//
+// Populates a random game and plays it until it is over or --rounds rounds (0:
+// no cap) have been played. Nothing is printed while the game runs unless
+// --output asks for the board; the run ends with a throughput and outcome
+// report. --mode defaults to tiled with more than one thread, serial
+// otherwise, as tiles only pay off when they run in parallel. live keeps the
+// board on an ANSI terminal up to date, at most --fps times a second (0: every
+// round that changes it), without slowing the game down to the terminal's
+// pace.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Game.h"
+#include "TerminalRenderer.h"
+
+using namespace std;
+using namespace Gaming;
+
+namespace {
+
+    struct Options {
+        unsigned int width = 100, height = 100;
+        double density = 0.75;          // fraction of cells holding a piece, a third of them agents
+        unsigned int seed = Game::DEFAULT_SEED;
+        unsigned int rounds = 0;
+        unsigned int threads = 1;
+        string mode = "";               // empty: tiled if threads > 1, else serial
+        string order = "id";            // turn order of serial rounds
+        string output = "none";
+        double fps = 30;                // frames per second of live output
+    };
+
+    void usage() {
+        cerr << "usage: ucd-csci2312-pa4-sim [--width N] [--height N] [--density D] [--seed N]" << endl
+             << "                            [--rounds N] [--threads N] [--mode serial|tiled|intent]" << endl
+             << "                            [--order id|grid|shuffled] [--output none|final|every|live]" << endl
+             << "                            [--fps N]" << endl;
+        exit(2);
+    }
+
+    double seconds(chrono::steady_clock::duration d) { return chrono::duration<double>(d).count(); }
+
+}
+
+int main(int argc, char *argv[]) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) usage();
+        const char *arg = argv[i], *val = argv[++i];
+        if (strcmp(arg, "--width") == 0) opt.width = (unsigned int) atoi(val);
+        else if (strcmp(arg, "--height") == 0) opt.height = (unsigned int) atoi(val);
+        else if (strcmp(arg, "--density") == 0) opt.density = atof(val);
+        else if (strcmp(arg, "--seed") == 0) opt.seed = (unsigned int) strtoul(val, nullptr, 10);
+        else if (strcmp(arg, "--rounds") == 0) opt.rounds = (unsigned int) atoi(val);
+        else if (strcmp(arg, "--threads") == 0) opt.threads = (unsigned int) atoi(val);
+        else if (strcmp(arg, "--mode") == 0) opt.mode = val;
+        else if (strcmp(arg, "--order") == 0) opt.order = val;
+        else if (strcmp(arg, "--output") == 0) opt.output = val;
+        else if (strcmp(arg, "--fps") == 0) opt.fps = atof(val);
+        else usage();
+    }
+
+    if (opt.mode.empty()) opt.mode = opt.threads > 1 ? "tiled" : "serial";
+    Game::RoundMode mode;
+    if (opt.mode == "serial") mode = Game::SERIAL;
+    else if (opt.mode == "tiled") mode = Game::TILED;
+    else if (opt.mode == "intent") mode = Game::INTENT;
+    else usage();
+    Game::TurnOrder order;
+    if (opt.order == "id") order = Game::ID_ORDER;
+    else if (opt.order == "grid") order = Game::GRID_ORDER;
+    else if (opt.order == "shuffled") order = Game::SHUFFLED;
+    else usage();
+    if (opt.output != "none" && opt.output != "final" && opt.output != "every" && opt.output != "live") usage();
+    if (opt.fps < 0) usage();
+    if (opt.density < 0 || opt.density > 1) usage();
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Game *game;
+    try {
+        game = new Game(opt.width, opt.height, true, opt.seed);
+    } catch (GamingException &ex) {
+        cerr << "Exception generated: " << ex;
+        return 1;
+    }
+    double pieces = (double) opt.width * opt.height * opt.density;
+    game->populate((unsigned int) (pieces / 3), (unsigned int) (pieces * 2 / 3));
+    game->setRoundMode(mode, opt.threads);
+    game->setTurnOrder(order);
+    double populateTime = seconds(chrono::steady_clock::now() - start);
+
+    if (opt.output == "every") cout << *game;
+    TerminalRenderer live(cout, opt.fps);
+    if (opt.output == "live") live.draw(*game);
+
+    unsigned long long piecesPlayed = 0, agentTurns = 0; // resources age but don't take turns
+    unsigned int played = 0;
+    start = chrono::steady_clock::now();
+    while (game->getStatus() != Game::OVER && (opt.rounds == 0 || played < opt.rounds)) {
+        piecesPlayed += game->getNumPieces();
+        agentTurns += game->getNumAgents();
+        game->simulate(1);
+        ++played;
+        if (opt.output == "every") cout << *game;
+        else if (opt.output == "live") live.draw(*game);
+    }
+    double playTime = seconds(chrono::steady_clock::now() - start);
+
+    if (opt.output == "final") cout << *game;
+    else if (opt.output == "live") live.finish(*game);
+
+    cout << "grid:            " << opt.width << "x" << opt.height << " (density " << opt.density
+         << ", seed " << opt.seed << ")" << endl;
+    cout << "mode:            " << opt.mode << ", " << game->getNumThreads() << " thread(s)"
+         << (mode == Game::SERIAL ? ", " + opt.order + " order" : "") << endl;
+    cout << "populate:        " << populateTime << " s" << endl;
+    cout << "rounds:          " << played << (game->getStatus() == Game::OVER ? " (game over)" : " (cut off)") << endl;
+    cout << "time:            " << playTime << " s" << endl;
+    cout << "rounds/sec:      " << (playTime > 0 ? played / playTime : 0) << endl;
+    cout << "pieces/sec:      " << (playTime > 0 ? piecesPlayed / playTime : 0) << endl;
+    cout << "agent turns/sec: " << (playTime > 0 ? agentTurns / playTime : 0) << endl;
+    cout << "survivors:       " << game->getNumSimple() << " simple, " << game->getNumStrategic()
+         << " strategic, " << game->getNumResources() << " resources" << endl;
+
+    delete game;
+    return 0;
+}
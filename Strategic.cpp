@@ -10,14 +10,31 @@ namespace Gaming{
     const char Strategic::STRATEGIC_ID = 'T';
     
     Strategic::Strategic(const Game &g, const Position &p, double energy, Strategy *s)
-            : Agent(g, p, energy) { __strategy = s; }
+            : Agent(g, p, energy) {
+        if (s) __strategy.reset(s);
+        else __strategy = DefaultAgentStrategy::shared();
+        __decision = nullptr;
+    }
+
+    Strategic::Strategic(const Game &g, const Position &p, double energy, shared_ptr<const Strategy> s)
+            : Agent(g, p, energy) {
+        __strategy = s ? std::move(s) : DefaultAgentStrategy::shared();
+        __decision = nullptr;
+    }
 
-    Strategic::~Strategic() { delete __strategy; }
+    Strategic::Strategic(const Game &g, const Position &p, double energy, Decision d)
+            : Agent(g, p, energy) { __decision = d; }
+
+    Strategic::~Strategic() { }
 
     void Strategic::print(ostream &os) const {
         os << STRATEGIC_ID << left << __id;
     }
 
-    ActionType Strategic::takeTurn(const Surroundings &s) const { return (*__strategy)(s); }
+    ActionType Strategic::takeTurn(const Surroundings &s) const {
+        CounterRng rng(__game.getSeed(), CounterRng::TURN, __id, __game.getRound());
+        if (__decision) return __decision(packSurroundings(s), rng);
+        return (*__strategy)(s, rng);
+    }
 
 }
\ No newline at end of file
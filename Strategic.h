@@ -5,6 +5,8 @@
 #ifndef PA5GAME_STRATEGIC_H
 #define PA5GAME_STRATEGIC_H
 
+#include <memory>
+
 #include "Game.h"
 #include "Agent.h"
 #include "Strategy.h"
@@ -14,12 +16,19 @@ namespace Gaming {
 
     class Strategic : public Agent {
     private:
-        static const char STRATEGIC_ID;
-
-        Strategy *__strategy;
+        std::shared_ptr<const Strategy> __strategy;
+        Decision __decision; // takes the place of __strategy if set
 
     public:
-        Strategic(const Game &g, const Position &p, double energy, Strategy *s = new DefaultAgentStrategy());
+        static const char STRATEGIC_ID;
+
+        // s is adopted and deleted with the agent; nullptr: the shared default strategy
+        Strategic(const Game &g, const Position &p, double energy, Strategy *s = nullptr);
+        Strategic(const Game &g, const Position &p, double energy, std::nullptr_t) :
+                Strategic(g, p, energy, (Strategy *) nullptr) { }
+        // s may be shared with other agents (a unique_ptr hands it over)
+        Strategic(const Game &g, const Position &p, double energy, std::shared_ptr<const Strategy> s);
+        Strategic(const Game &g, const Position &p, double energy, Decision d);
         ~Strategic();
 
         PieceType getType() const override { return PieceType::STRATEGIC; }
@@ -28,6 +37,8 @@ namespace Gaming {
 
         ActionType takeTurn(const Surroundings &s) const override;
 
+        const Strategy *getStrategy() const override { return __strategy.get(); }
+
     };
 
 }
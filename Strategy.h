@@ -9,11 +9,33 @@
 
 namespace Gaming {
 
+    // a strategy as a plain function, for agents that need no Strategy object
+    typedef ActionType (*Decision)(SurroundingsKey key, CounterRng &rng);
+
     class Strategy {
     public:
         Strategy() {}
         virtual ~Strategy() {};
         virtual ActionType operator()(const Surroundings &s) const = 0;
+
+        // agents call this one, handing in their own generator for the round;
+        // strategies that don't randomize need not override it
+        virtual ActionType operator()(const Surroundings &s, CounterRng &rng) const { return (*this)(s); }
+
+        // same decision from a packed neighborhood; strategies that work on
+        // keys override this one and pack in the Surroundings overloads
+        virtual ActionType operator()(SurroundingsKey key, CounterRng &rng) const {
+            return (*this)(unpackSurroundings(key), rng);
+        }
+
+        // n agents deciding at once: agent k sees keys[k] and draws from
+        // rngs[k], and its choice goes to actions[k]. Same result as n single
+        // calls; overriding it saves a virtual call per agent.
+        virtual void decideBatch(const SurroundingsKey *keys, CounterRng *rngs,
+                                 ActionType *actions, unsigned int n) const {
+            for (unsigned int k = 0; k < n; ++k)
+                actions[k] = (*this)(keys[k], rngs[k]);
+        }
     };
 
 }
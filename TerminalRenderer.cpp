@@ -0,0 +1,133 @@
+#include "TerminalRenderer.h"
+#include "Piece.h"
+
+using namespace std;
+
+namespace Gaming {
+
+    const unsigned int TerminalRenderer::NONE = 0; // ids start at Game::FIRST_PIECE_ID
+
+    TerminalRenderer::TerminalRenderer(ostream &os, double maxFps) :
+            __os(os),
+            __interval(maxFps > 0 ? chrono::duration_cast<chrono::steady_clock::duration>(
+                    chrono::duration<double>(1 / maxFps)) : chrono::steady_clock::duration::zero()),
+            __width(0), __height(0), __cellWidth(0),
+            __status(Game::NOT_STARTED),
+            __drawn(false) { }
+
+    void TerminalRenderer::appendCell(const Piece *piece) {
+        __frame.push_back('[');
+        unsigned int used = 0;
+        if (piece != nullptr) {
+            appendLabel(__frame, piece->getType(), piece->getId());
+            used = labelWidth(piece->getId());
+        }
+        __frame.append(__cellWidth - 2 - used, ' ');
+        __frame.push_back(']');
+    }
+
+    void TerminalRenderer::appendStatus(Game::Status status) {
+        __frame.append("Status: ");
+        switch (status) {
+            case Game::NOT_STARTED:
+                __frame.append("Not Started..."); break;
+            case Game::PLAYING:
+                __frame.append("Playing..."); break;
+            default:
+                __frame.append("Over!"); break;
+        }
+        __frame.append("\x1b[K"); // clear the rest of the line
+    }
+
+    void TerminalRenderer::moveTo(unsigned int row, unsigned int column) {
+        __frame.append("\x1b[");
+        appendNumber(__frame, row);
+        __frame.push_back(';');
+        appendNumber(__frame, column);
+        __frame.push_back('H');
+    }
+
+    void TerminalRenderer::redraw(const Game &game) {
+        __width = game.getWidth();
+        __height = game.getHeight();
+        __cellWidth = 2 + labelWidth(game.getMaxId());
+        __shown.assign(__width * __height, NONE);
+
+        __frame.append("\x1b[2J\x1b[H"); // clear the screen, cursor home
+        __frame.append("Round ");
+        appendNumber(__frame, game.getRound());
+        __frame.push_back('\n');
+        for (unsigned int x = 0; x < __height; ++x) {
+            for (unsigned int y = 0; y < __width; ++y) {
+                const Piece *piece = game.pieceAt(x, y);
+                appendCell(piece);
+                if (piece != nullptr) __shown[x * __width + y] = piece->getId();
+            }
+            __frame.push_back('\n');
+        }
+        __status = game.getStatus();
+        appendStatus(__status);
+    }
+
+    // Cells are compared with what is on screen rather than tracked as the
+    // game changes them, so any number of rounds between frames costs one
+    // pass over the board. A run of changed cells needs one cursor move.
+    bool TerminalRenderer::update(const Game &game) {
+        bool changed = false;
+        for (unsigned int x = 0; x < __height; ++x) {
+            bool atCursor = false;
+            for (unsigned int y = 0; y < __width; ++y) {
+                const Piece *piece = game.pieceAt(x, y);
+                unsigned int id = piece != nullptr ? piece->getId() : NONE;
+                unsigned int &shown = __shown[x * __width + y];
+                if (id == shown) {
+                    atCursor = false;
+                    continue;
+                }
+                if (!atCursor) moveTo(x + 2, y * __cellWidth + 1);
+                appendCell(piece);
+                shown = id;
+                atCursor = changed = true;
+            }
+        }
+        if (!changed && game.getStatus() == __status)
+            return false;
+
+        moveTo(1, 1);
+        __frame.append("Round ");
+        appendNumber(__frame, game.getRound());
+        __frame.append("\x1b[K");
+        __status = game.getStatus();
+        moveTo(__height + 2, 1);
+        appendStatus(__status);
+        return true;
+    }
+
+    bool TerminalRenderer::draw(const Game &game, bool force) {
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        if (__drawn && !force && now - __last < __interval)
+            return false;
+
+        __frame.clear();
+        if (!__drawn || game.getWidth() != __width || game.getHeight() != __height ||
+            2 + labelWidth(game.getMaxId()) != __cellWidth)
+            redraw(game);
+        else if (!update(game))
+            return false;
+
+        __os.write(__frame.data(), __frame.size());
+        __os.flush();
+        __last = now;
+        __drawn = true;
+        return true;
+    }
+
+    void TerminalRenderer::finish(const Game &game) {
+        draw(game, true);
+        __frame.clear();
+        moveTo(__height + 3, 1);
+        __os.write(__frame.data(), __frame.size());
+        __os.flush();
+    }
+
+}
@@ -0,0 +1,56 @@
+//
+// Live view of a Game on an ANSI terminal.
+//
+
+#ifndef PA5GAME_TERMINALRENDERER_H
+#define PA5GAME_TERMINALRENDERER_H
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Game.h"
+
+namespace Gaming {
+
+    // The first frame clears the screen and draws the whole board, laid out
+    // like operator<< but with every cell as wide as the largest id needs.
+    // Later frames move the cursor to the cells that changed since the last
+    // frame drawn and rewrite only those, plus the round and status lines.
+    // Frames come at most maxFps times a second (0: no limit) and frames in
+    // which no cell changed are skipped, so a game can call draw() every
+    // round and play at full speed however slow the terminal is.
+    class TerminalRenderer {
+        std::ostream &__os;
+        std::chrono::steady_clock::duration __interval;
+        std::chrono::steady_clock::time_point __last;
+
+        unsigned int __width, __height, __cellWidth; // of the board on screen
+        std::vector<unsigned int> __shown;           // per cell, id of the piece on screen or NONE
+        Game::Status __status;
+        std::string __frame;
+        bool __drawn;
+
+        static const unsigned int NONE;
+
+        void appendCell(const Piece *piece); // nullptr: an empty cell
+        void appendStatus(Game::Status status);
+        void moveTo(unsigned int row, unsigned int column); // 1-based screen coordinates
+        void redraw(const Game &game);
+        bool update(const Game &game); // false if nothing changed
+
+    public:
+        explicit TerminalRenderer(std::ostream &os = std::cout, double maxFps = 30);
+
+        // draw a frame of the game if one is due and anything changed,
+        // return whether it did; force: regardless of the rate limit
+        bool draw(const Game &game, bool force = false);
+
+        // draw the last frame and put the cursor under the board
+        void finish(const Game &game);
+    };
+
+}
+
+#endif //PA5GAME_TERMINALRENDERER_H
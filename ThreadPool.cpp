@@ -0,0 +1,118 @@
+#include "ThreadPool.h"
+
+using namespace std;
+
+namespace Gaming {
+
+    ThreadPool::ThreadPool(unsigned int numThreads) :
+            __task(nullptr), __busy(0), __generation(0), __stopping(false) {
+        if (numThreads == 0) numThreads = 1;
+        for (unsigned int i = 0; i < numThreads; ++i)
+            __shares.push_back(unique_ptr<Share>(new Share()));
+        for (unsigned int i = 1; i < numThreads; ++i)
+            __workers.push_back(thread(&ThreadPool::work, this, i));
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            lock_guard<mutex> lock(__mutex);
+            __stopping = true;
+        }
+        __wake.notify_all();
+        for (auto it = __workers.begin(); it != __workers.end(); ++it)
+            it->join();
+    }
+
+    // move the back half of some other thread's share into ours
+    bool ThreadPool::steal(unsigned int self) {
+        const unsigned int n = (unsigned int) __shares.size();
+        for (unsigned int k = 1; k < n; ++k) {
+            Share &victim = *__shares[(self + k) % n];
+            unsigned int begin, end;
+            {
+                lock_guard<mutex> lock(victim.lock);
+                if (victim.begin >= victim.end) continue;
+                end = victim.end;
+                begin = victim.begin + (victim.end - victim.begin) / 2;
+                victim.end = begin;
+            }
+            Share &own = *__shares[self];
+            lock_guard<mutex> lock(own.lock);
+            own.begin = begin;
+            own.end = end;
+            return true;
+        }
+        return false;
+    }
+
+    // run items of the current job until no thread has any left
+    void ThreadPool::drain(unsigned int self) {
+        Share &own = *__shares[self];
+        do {
+            while (true) {
+                unsigned int i;
+                {
+                    lock_guard<mutex> lock(own.lock);
+                    if (own.begin >= own.end) break;
+                    i = own.begin++;
+                }
+                try {
+                    (*__task)(i);
+                } catch (...) {
+                    lock_guard<mutex> lock(__mutex);
+                    if (!__error) __error = current_exception();
+                }
+            }
+        } while (steal(self));
+    }
+
+    void ThreadPool::work(unsigned int self) {
+        unsigned long seen = 0;
+        while (true) {
+            {
+                unique_lock<mutex> lock(__mutex);
+                __wake.wait(lock, [&] { return __stopping || __generation != seen; });
+                if (__stopping) return;
+                seen = __generation;
+            }
+            drain(self);
+            {
+                lock_guard<mutex> lock(__mutex);
+                if (--__busy == 0) __done.notify_one();
+            }
+        }
+    }
+
+    void ThreadPool::parallelFor(unsigned int n, const Task &task) {
+        if (n == 0) return;
+        if (__workers.empty() || n == 1) {
+            for (unsigned int i = 0; i < n; ++i) task(i);
+            return;
+        }
+        {
+            lock_guard<mutex> lock(__mutex);
+            const unsigned int numShares = (unsigned int) __shares.size();
+            for (unsigned int t = 0; t < numShares; ++t) {
+                lock_guard<mutex> shareLock(__shares[t]->lock);
+                __shares[t]->begin = (unsigned int) ((unsigned long long) n * t / numShares);
+                __shares[t]->end = (unsigned int) ((unsigned long long) n * (t + 1) / numShares);
+            }
+            __task = &task;
+            __busy = (unsigned int) __workers.size();
+            __error = nullptr;
+            ++__generation;
+        }
+        __wake.notify_all();
+        drain(0);
+
+        exception_ptr error;
+        {
+            unique_lock<mutex> lock(__mutex);
+            __done.wait(lock, [&] { return __busy == 0; });
+            __task = nullptr;
+            error = __error;
+        }
+        if (error) rethrow_exception(error);
+    }
+
+}
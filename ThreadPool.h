@@ -0,0 +1,64 @@
+//
+// Fixed-size worker pool used by the parallel round modes.
+//
+
+#ifndef PA5GAME_THREADPOOL_H
+#define PA5GAME_THREADPOOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Gaming {
+
+    class ThreadPool {
+    public:
+        typedef std::function<void(unsigned int)> Task;
+
+    private:
+        std::vector<std::thread> __workers;
+
+        std::mutex __mutex;
+        std::condition_variable __wake, __done;
+
+        // Each thread starts a job with an even share of the items and works
+        // through it front to back. A thread that runs dry steals the back half
+        // of another thread's remaining share, so uneven items balance out.
+        struct Share {
+            std::mutex lock;
+            unsigned int begin, end;
+        };
+        std::vector<std::unique_ptr<Share>> __shares; // [0] belongs to the calling thread
+
+        // the job currently being run by parallelFor()
+        const Task *__task;
+        unsigned int __busy;            // workers still inside the current job
+        unsigned long __generation;     // bumped for every new job
+        std::exception_ptr __error;
+        bool __stopping;
+
+        void work(unsigned int self);
+        void drain(unsigned int self);
+        bool steal(unsigned int self);
+
+    public:
+        explicit ThreadPool(unsigned int numThreads);
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+        ~ThreadPool();
+
+        // the calling thread counts as one of them
+        unsigned int getNumThreads() const { return (unsigned int) __workers.size() + 1; }
+
+        // run task(0) .. task(n - 1), returning once all are done; the first
+        // exception thrown by a task is rethrown here
+        void parallelFor(unsigned int n, const Task &task);
+    };
+
+}
+
+#endif //PA5GAME_THREADPOOL_H
@@ -49,6 +49,10 @@ int main() {
     test_game_print(ec, NumIters);
     test_game_randomization(ec, NumIters);
     test_game_play(ec, NumIters);
+    test_game_parallel(ec, NumIters);
+
+    // batch tests
+    test_batch_runner(ec, NumIters);
 
     return 0;
 }
\ No newline at end of file